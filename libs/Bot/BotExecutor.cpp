@@ -0,0 +1,133 @@
+#include "BotExecutor.h"
+#include <algorithm>
+
+// --- latency histogram ---
+void LatencyHistogram::record(std::chrono::microseconds latency) {
+    uint64_t micros = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    size_t bucket = 0;
+    while (bucket + 1 < kBuckets && (micros >> bucket) != 0) {
+        bucket++;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (micros > seen && !max_.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentileMicros(double q) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+    rank = std::min(std::max<uint64_t>(rank, 1), total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; i++) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return i + 1 == kBuckets ? maxMicros() : std::min(upperBoundMicros(i), maxMicros());
+        }
+    }
+    return maxMicros();
+}
+
+uint64_t LatencyHistogram::cumulativeCount(size_t bucket) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i <= bucket && i < kBuckets; i++) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return seen;
+}
+
+// --- executor ---
+BotExecutor::BotExecutor(size_t threads) : threadCount_(std::max<size_t>(threads, 1)) {}
+
+BotExecutor::~BotExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workReady_.notify_all();
+    timerReady_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    if (timerThread_.joinable()) {
+        timerThread_.join();
+    }
+}
+
+void BotExecutor::start() {
+    for (size_t i = 0; i < threadCount_; i++) {
+        workers_.emplace_back(&BotExecutor::workerLoop, this);
+    }
+    timerThread_ = std::thread(&BotExecutor::timerLoop, this);
+}
+
+void BotExecutor::submit(Task task) {
+    std::call_once(startOnce_, [this] { start(); });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    workReady_.notify_one();
+}
+
+void BotExecutor::runAfter(std::chrono::milliseconds delay, Task task) {
+    std::call_once(startOnce_, [this] { start(); });
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers_.push({Clock::now() + delay, nextTimerOrder_++, std::move(task)});
+        earliest = timers_.top().order == nextTimerOrder_ - 1;
+    }
+    if (earliest) {
+        timerReady_.notify_one();
+    }
+}
+
+void BotExecutor::recordLatency(int command, std::chrono::microseconds latency) {
+    if (command >= 0 && static_cast<size_t>(command) < kMaxCommands) {
+        histograms_[static_cast<size_t>(command)].record(latency);
+    }
+}
+
+const LatencyHistogram& BotExecutor::histogram(int command) const {
+    size_t index = command >= 0 && static_cast<size_t>(command) < kMaxCommands ? static_cast<size_t>(command) : 0;
+    return histograms_[index];
+}
+
+void BotExecutor::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        workReady_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+            return;     // Stopping and drained
+        }
+        Task task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void BotExecutor::timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (timers_.empty()) {
+            timerReady_.wait(lock);
+            continue;
+        }
+        Clock::time_point due = timers_.top().due;    // A copy: pushes may move the heap while we wait
+        if (due > Clock::now()) {
+            timerReady_.wait_until(lock, due);
+            continue;
+        }
+        Task task = std::move(const_cast<Timer&>(timers_.top()).task);
+        timers_.pop();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
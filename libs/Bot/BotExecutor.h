@@ -0,0 +1,99 @@
+#ifndef BOTEXECUTOR_H
+#define BOTEXECUTOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief هیستوگرام تأخیر با سطل‌های توانی از دو (میکروثانیه)
+ *
+ * ثبت بدون قفل است؛ صدک‌ها از روی سطل‌ها تخمین زده می‌شوند (حداکثر خطا: دو برابر).
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kBuckets = 32;     // Bucket i: [2^(i-1), 2^i) us; the last one is open-ended
+
+    void record(std::chrono::microseconds latency);
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sumMicros() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t maxMicros() const { return max_.load(std::memory_order_relaxed); }
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1); 0 when empty
+    uint64_t percentileMicros(double q) const;
+    // Cumulative count of samples <= upperBoundMicros(i), for exporters
+    uint64_t cumulativeCount(size_t bucket) const;
+    static uint64_t upperBoundMicros(size_t bucket) { return bucket == 0 ? 0 : (uint64_t{1} << bucket) - 1; }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief استخر کارگر مشترک برای اجرای ناهمگام دستورهای ربات
+ *
+ * یک نمونه بین ربات‌های همه‌ی کاربران مشترک است، تا درخواست‌های کاربران مختلف
+ * هم‌زمان پیش بروند بدون اینکه هر کاربر نخ‌های خودش را داشته باشد.
+ * نخ‌ها با اولین کار ساخته می‌شوند. یک نخ زمان‌سنج کارهای تأخیری (مهلت‌ها) را اجرا می‌کند.
+ */
+class BotExecutor {
+public:
+    using Task = std::function<void()>;
+    static constexpr size_t kMaxCommands = 16;  // Histograms are indexed by command number
+
+    explicit BotExecutor(size_t threads = std::thread::hardware_concurrency());
+    ~BotExecutor();     // Runs what is already queued, drops pending timers
+
+    BotExecutor(const BotExecutor&) = delete;
+    BotExecutor& operator=(const BotExecutor&) = delete;
+
+    void submit(Task task);
+    // Runs task on the timer thread once delay has passed; keep it short
+    void runAfter(std::chrono::milliseconds delay, Task task);
+
+    void recordLatency(int command, std::chrono::microseconds latency);
+    const LatencyHistogram& histogram(int command) const;
+    size_t threadCount() const { return threadCount_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Timer {
+        Clock::time_point due;
+        uint64_t order;     // FIFO among timers due at the same instant
+        Task task;
+        bool operator>(const Timer& other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    size_t threadCount_;
+    std::once_flag startOnce_;
+    std::vector<std::thread> workers_;
+    std::thread timerThread_;
+
+    std::mutex mutex_;
+    std::condition_variable workReady_;
+    std::condition_variable timerReady_;
+    std::deque<Task> tasks_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t nextTimerOrder_ = 0;
+    bool stopping_ = false;
+
+    std::array<LatencyHistogram, kMaxCommands> histograms_;
+
+    void start();
+    void workerLoop();
+    void timerLoop();
+};
+
+#endif // BOTEXECUTOR_H
@@ -1,92 +1,318 @@
 #include "BotManager.h"
+#include "UserStatsTracker.h"
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 // --- Seyedmujtaba Tabatabaee ---
+BotManager::BotManager(BotManagerDeps deps, BotManagerConfig cfg, std::shared_ptr<BotExecutor> executor,
+                       std::shared_ptr<BotResultCache> cache, std::shared_ptr<UserStatsTracker> statsTracker)
+    : deps_(std::move(deps)), config_(std::move(cfg)),
+      executor_(executor ? std::move(executor) : std::make_shared<BotExecutor>()),
+      cache_(cache ? std::move(cache) : std::make_shared<BotResultCache>()),
+      statsTracker_(std::move(statsTracker)) {}
+
+BotManager::~BotManager() {
+    std::unique_lock<std::mutex> lock(inFlightMutex_);
+    inFlightDone_.wait(lock, [this] { return inFlight_ == 0; });
+}
+
 // --- build menu text ---
 std::string BotManager::buildMenuText() const {
     std::ostringstream oss;
-    oss << "Bot Menu\n";
+    oss << config_.botDisplayName << "\n";
     oss << "----------------------\n";
-    oss << "1) Unread messages count\n";
-    oss << "2) My profile\n";
-    oss << "3) Last messages (args: limit)\n";
-    oss << "4) Search messages (args: query, limit)\n";
-    oss << "5) Reminders\n";
-    oss << "6) Stats\n";
-    oss << "7) Clear chat history\n";
-    oss << "8) Help\n";
-    oss << "Enter a choice (1-8):";
+    for (const auto& option : config_.menuOptionsFA) {
+        oss << option << "\n";
+    }
+    oss << "Enter a choice (1-" << config_.menuOptionsFA.size() << "):";
     return oss.str();
 }
 
 // --- handle choice ---
-BotResponse BotManager::handleChoice(const std::string& userId, int choice,
-                                     const std::unordered_map<std::string, std::string>& args) {
-    if (!userManager.isUserLoggedIn(userId)) {
-        return BotResponse("User not logged in. Please login first.", false, 401);
+std::string BotManager::handleChoice(int choice,
+                                     const std::unordered_map<std::string, std::string>& args) const {
+    BotResultCache::Ticket ticket;
+    if (auto cached = cachedReply(choice, args, ticket)) {
+        return *cached;
     }
+    std::string text = runChoice(choice, args);
+    storeReply(choice, args, text, ticket);
+    return text;
+}
 
+std::string BotManager::runChoice(int choice,
+                                  const std::unordered_map<std::string, std::string>& args) const {
     switch (choice) {
         case static_cast<int>(MenuItem::UnreadCount):
-            return handleUnreadCount(userId);
+            return handleUnreadCount();
         case static_cast<int>(MenuItem::UserProfile):
-            return handleUserProfile(userId);
-        case static_cast<int>(MenuItem::LastMessages): {
-            size_t limit = 10;
-            if (auto it = args.find("limit"); it != args.end()) {
-                try { limit = std::stoul(it->second); } catch (...) {}
-            }
-            return handleLastMessages(userId, limit);
-        }
+            return handleUserProfile();
+        case static_cast<int>(MenuItem::OnlineContacts):
+            return handleOnlineContacts();
+        case static_cast<int>(MenuItem::LastMessages):
+            return handleLastMessages(parseLimit(args, config_.defaultLastMessagesLimit));
         case static_cast<int>(MenuItem::SearchMessages): {
             std::string query;
-            size_t limit = 10;
             if (auto it = args.find("query"); it != args.end()) query = it->second;
-            if (auto it = args.find("limit"); it != args.end()) {
-                try { limit = std::stoul(it->second); } catch (...) {}
+            return handleSearchMessages(query, parseLimit(args, config_.defaultSearchLimit));
+        }
+        case static_cast<int>(MenuItem::Reminders): {
+            std::string text;
+            if (auto it = args.find("title"); it != args.end()) {
+                long minutes = 0;
+                if (auto m = args.find("minutes"); m != args.end()) {
+                    try { minutes = std::stol(m->second); } catch (...) {}
+                }
+                text = handleAddReminder(it->second, std::chrono::minutes(minutes));
+            } else if (auto it = args.find("cancel"); it != args.end()) {
+                text = handleCancelReminder(it->second);
+            } else {
+                return handleReminders();
             }
-            return handleSearchMessages(userId, query, limit);
+            if (!config_.userId.empty()) cache_->invalidateUser(config_.userId);
+            return text + "\n" + handleReminders();
         }
-        case static_cast<int>(MenuItem::Reminders):
-            return handleReminders(userId);
-        case static_cast<int>(MenuItem::Stats):
-            return handleStats(userId);
-        case static_cast<int>(MenuItem::ClearChatHistory):
-            return handleClearChatHistory(userId);
         case static_cast<int>(MenuItem::Help):
             return handleHelp();
+        case static_cast<int>(MenuItem::Settings): {
+            std::string text = handleSettings(args);
+            if (!config_.userId.empty()) cache_->invalidateUser(config_.userId);
+            return text;
+        }
+        case static_cast<int>(MenuItem::ClearChatHistory): {
+            std::string text = handleClearChatHistory();
+            if (!config_.userId.empty()) cache_->invalidateUser(config_.userId);
+            return text;
+        }
+        case static_cast<int>(MenuItem::Stats):
+            return handleStats();
         default:
-            return BotResponse("Invalid choice. Please enter a valid number.", false, 400);
+            return "Invalid choice. Please enter a valid number.";
+    }
+}
+
+// --- result cache ---
+std::string BotManager::cacheArgsKey(int choice, const std::unordered_map<std::string, std::string>& args) const {
+    // Only the arguments the handler reads, after defaults, so equivalent requests share an entry
+    switch (choice) {
+        case static_cast<int>(MenuItem::LastMessages):
+            return std::to_string(parseLimit(args, config_.defaultLastMessagesLimit));
+        case static_cast<int>(MenuItem::SearchMessages): {
+            auto it = args.find("query");
+            return (it != args.end() ? it->second : std::string()) + '\x1f' +
+                   std::to_string(parseLimit(args, config_.defaultSearchLimit));
+        }
+        default:
+            return "";
+    }
+}
+
+std::optional<std::string> BotManager::cachedReply(int choice,
+                                                   const std::unordered_map<std::string, std::string>& args,
+                                                   BotResultCache::Ticket& ticket) const {
+    if (config_.userId.empty() || !config_.cacheTtl.count(choice) || changesState(choice, args)) {
+        return std::nullopt;
+    }
+    return cache_->get(config_.userId, choice, cacheArgsKey(choice, args), ticket);
+}
+
+void BotManager::storeReply(int choice, const std::unordered_map<std::string, std::string>& args,
+                            const std::string& text, const BotResultCache::Ticket& ticket) const {
+    auto ttl = config_.cacheTtl.find(choice);
+    if (config_.userId.empty() || ttl == config_.cacheTtl.end() || ttl->second.count() <= 0 ||
+        changesState(choice, args)) {
+        return;
     }
+    // Profiles, presence and reminders do not change with messages; they live out their TTL
+    bool dependsOnMessages = choice == static_cast<int>(MenuItem::UnreadCount) ||
+                             choice == static_cast<int>(MenuItem::LastMessages) ||
+                             choice == static_cast<int>(MenuItem::SearchMessages) ||
+                             choice == static_cast<int>(MenuItem::Stats);
+    cache_->put(config_.userId, choice, cacheArgsKey(choice, args), text, ttl->second, dependsOnMessages, ticket);
+}
+
+void BotManager::onMessageEvent(const std::string& fromUserId, const std::string& toUserId, bool isNewMessage) const {
+    if (statsTracker_ && isNewMessage) {
+        statsTracker_->record(fromUserId, toUserId);
+    }
+    cache_->invalidateMessages(fromUserId);
+    if (toUserId != fromUserId) {
+        cache_->invalidateMessages(toUserId);
+    }
+}
+
+// --- async ---
+namespace {
+// One async request: its sections fill in as handlers finish; the first of
+// "all sections done" and "deadline passed" fulfils the promise.
+struct PendingReply {
+    std::mutex mutex;
+    std::vector<std::string> sections;
+    std::vector<bool> done;
+    size_t remaining;
+    bool fulfilled = false;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::promise<BotReply> promise;
+
+    explicit PendingReply(size_t count) : sections(count), done(count, false), remaining(count) {}
+
+    void fulfil(bool complete) {    // Call with mutex held
+        BotReply reply;
+        reply.complete = complete;
+        for (size_t i = 0; i < sections.size(); i++) {
+            if (i > 0) reply.text += "\n\n";
+            reply.text += done[i] ? sections[i] : "Not ready in time, please try again.";
+        }
+        reply.latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        fulfilled = true;
+        promise.set_value(std::move(reply));
+    }
+
+    void finish(size_t index, std::string text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fulfilled) return;     // Too late: the partial reply has gone out
+        sections[index] = std::move(text);
+        done[index] = true;
+        if (--remaining == 0) fulfil(true);
+    }
+
+    void expire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fulfilled) fulfil(false);
+    }
+};
+}
+
+std::future<BotReply> BotManager::handleChoiceAsync(int choice,
+                                                    const std::unordered_map<std::string, std::string>& args) const {
+    return handleChoicesAsync({choice}, args);
+}
+
+std::future<BotReply> BotManager::handleChoicesAsync(const std::vector<int>& choices,
+                                                     const std::unordered_map<std::string, std::string>& args) const {
+    auto pending = std::make_shared<PendingReply>(choices.size());
+    std::future<BotReply> future = pending->promise.get_future();
+    if (choices.empty()) {
+        pending->expire();
+        return future;
+    }
+
+    auto sharedArgs = std::make_shared<const std::unordered_map<std::string, std::string>>(args);
+    // Every section is an independent dependency call, so they all start at once.
+    // Cached sections are answered here without a trip through the pool.
+    for (size_t i = 0; i < choices.size(); i++) {
+        int choice = choices[i];
+        BotResultCache::Ticket ticket;
+        if (auto cached = cachedReply(choice, args, ticket)) {
+            pending->finish(i, std::move(*cached));
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(inFlightMutex_);
+            inFlight_++;
+        }
+        executor_->submit([this, pending, sharedArgs, choice, i, ticket] {
+            auto start = std::chrono::steady_clock::now();
+            std::string text;
+            try {
+                text = runChoice(choice, *sharedArgs);
+                storeReply(choice, *sharedArgs, text, ticket);
+            } catch (const std::exception& e) {
+                text = std::string("Something went wrong: ") + e.what();
+            }
+            executor_->recordLatency(choice, std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start));
+            pending->finish(i, std::move(text));
+
+            std::lock_guard<std::mutex> lock(inFlightMutex_);
+            if (--inFlight_ == 0) inFlightDone_.notify_all();
+        });
+    }
+    if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        executor_->runAfter(config_.commandDeadline, [pending] { pending->expire(); });
+    }
+    return future;
+}
+
+std::string BotManager::exportLatencyMetrics() const {
+    std::ostringstream oss;
+    oss << "# HELP bot_command_latency_microseconds Time to run one bot command on the worker pool\n";
+    oss << "# TYPE bot_command_latency_microseconds histogram\n";
+    for (int choice = static_cast<int>(MenuItem::UnreadCount); choice <= static_cast<int>(MenuItem::Stats); choice++) {
+        const LatencyHistogram& histogram = executor_->histogram(choice);
+        if (histogram.count() == 0) continue;
+        std::string label = std::string("command=\"") + commandName(choice) + "\"";
+        for (size_t bucket = 0; bucket + 1 < LatencyHistogram::kBuckets; bucket++) {
+            if (LatencyHistogram::upperBoundMicros(bucket) > histogram.maxMicros() * 2 + 1) break;
+            oss << "bot_command_latency_microseconds_bucket{" << label << ",le=\""
+                << LatencyHistogram::upperBoundMicros(bucket) << "\"} " << histogram.cumulativeCount(bucket) << "\n";
+        }
+        oss << "bot_command_latency_microseconds_bucket{" << label << ",le=\"+Inf\"} " << histogram.count() << "\n";
+        oss << "bot_command_latency_microseconds_sum{" << label << "} " << histogram.sumMicros() << "\n";
+        oss << "bot_command_latency_microseconds_count{" << label << "} " << histogram.count() << "\n";
+    }
+
+    BotResultCache::Stats cache = cache_->stats();
+    oss << "# HELP bot_cache_requests_total Cached bot commands by outcome\n";
+    oss << "# TYPE bot_cache_requests_total counter\n";
+    for (int choice = static_cast<int>(MenuItem::UnreadCount); choice <= static_cast<int>(MenuItem::Stats); choice++) {
+        size_t slot = static_cast<size_t>(choice);
+        if (cache.commandHits[slot] + cache.commandMisses[slot] == 0) continue;
+        oss << "bot_cache_requests_total{command=\"" << commandName(choice) << "\",result=\"hit\"} "
+            << cache.commandHits[slot] << "\n";
+        oss << "bot_cache_requests_total{command=\"" << commandName(choice) << "\",result=\"miss\"} "
+            << cache.commandMisses[slot] << "\n";
+    }
+    uint64_t lookups = cache.hits + cache.misses;
+    oss << "bot_cache_hit_ratio " << (lookups ? static_cast<double>(cache.hits) / static_cast<double>(lookups) : 0.0) << "\n";
+    oss << "bot_cache_evictions_total " << cache.evictions << "\n";
+    oss << "bot_cache_invalidated_total " << cache.invalidated << "\n";
+    oss << "bot_cache_expired_total " << cache.expired << "\n";
+    oss << "bot_cache_entries " << cache.entries << "\n";
+    oss << "bot_cache_bytes " << cache.bytes << "\n";
+    return oss.str();
 }
 
 // --- handlers ---
 
-BotResponse BotManager::handleUnreadCount(const std::string& userId) const {
-    int count = dbManager.fetchUnreadCount(userId);
+std::string BotManager::handleUnreadCount() const {
+    if (!deps_.fetchUnreadCount) return "Not available.";
+    int count = deps_.fetchUnreadCount();
     std::ostringstream oss;
     oss << "Unread messages: " << count;
-    return BotResponse(oss.str());
+    return oss.str();
 }
 
-BotResponse BotManager::handleUserProfile(const std::string& userId) const {
-    auto profile = userManager.getUserProfile(userId);
-    if (!profile.has_value()) {
-        return BotResponse("User profile not found.", false, 404);
-    }
+std::string BotManager::handleUserProfile() const {
+    if (!deps_.fetchUserProfile) return "User profile not found.";
+    UserProfile profile = deps_.fetchUserProfile();
     std::ostringstream oss;
     oss << "My profile\n"
-        << "Name: " << profile->displayName << "\n"
-        << "Phone: " << (!profile->phone.empty() ? profile->phone : "-") << "\n"
-        << "Presence: " << (profile->isOnline ? "Online" : "Offline") << "\n"
-        << "Status: " << (!profile->statusText.empty() ? profile->statusText : "-");
-    return BotResponse(oss.str());
+        << "Name: " << profile.displayName << "\n"
+        << "Phone: " << (!profile.phone.empty() ? profile.phone : "-") << "\n"
+        << "Presence: " << (profile.isOnline ? "Online" : "Offline") << "\n"
+        << "Status: " << (!profile.statusText.empty() ? profile.statusText : "-");
+    return oss.str();
+}
+
+std::string BotManager::handleOnlineContacts() const {
+    if (!deps_.fetchOnlineContacts) return "Not available.";
+    auto contacts = deps_.fetchOnlineContacts();
+    if (contacts.empty()) return "No contacts online.";
+    std::ostringstream oss;
+    oss << "Online contacts (" << contacts.size() << "):\n";
+    size_t idx = 1;
+    for (const auto& c : contacts) {
+        oss << idx++ << ") " << (!c.displayName.empty() ? c.displayName : c.id) << "\n";
+    }
+    return oss.str();
 }
 
-BotResponse BotManager::handleLastMessages(const std::string& userId, size_t limit) const {
-    auto msgs = dbManager.fetchLastMessages(userId, limit);
-    if (msgs.empty()) return BotResponse("No messages to show.");
+std::string BotManager::handleLastMessages(size_t limit) const {
+    if (!deps_.fetchLastMessages) return "Not available.";
+    auto msgs = deps_.fetchLastMessages(limit);
+    if (msgs.empty()) return "No messages to show.";
     std::ostringstream oss;
     oss << "Last messages (" << msgs.size() << "):\n";
     size_t idx = 1;
@@ -97,14 +323,15 @@ BotResponse BotManager::handleLastMessages(const std::string& userId, size_t lim
             << truncate(m.text, 80)
             << (m.isRead ? "" : "  (new)") << "\n";
     }
-    return BotResponse(oss.str());
+    return oss.str();
 }
 
-BotResponse BotManager::handleSearchMessages(const std::string& userId, const std::string& query, size_t limit) const {
-    if (query.empty()) return BotResponse("Please provide a query string to search.", false, 422);
-    auto results = dbManager.searchMessages(userId, query, limit);
+std::string BotManager::handleSearchMessages(const std::string& query, size_t limit) const {
+    if (query.empty()) return "Please provide a query string to search.";
+    if (!deps_.searchMessages) return "Not available.";
+    auto results = deps_.searchMessages(query, limit);
     if (results.empty()) {
-        return BotResponse("No results for \"" + query + "\".");
+        return "No results for \"" + query + "\".";
     }
     std::ostringstream oss;
     oss << "Search results for \"" << query << "\" (" << results.size() << "):\n";
@@ -115,12 +342,13 @@ BotResponse BotManager::handleSearchMessages(const std::string& userId, const st
             << m.fromUserId << " -> " << m.toUserId << " : "
             << truncate(m.text, 80) << "\n";
     }
-    return BotResponse(oss.str());
+    return oss.str();
 }
 
-BotResponse BotManager::handleReminders(const std::string& userId) const {
-    auto rems = dbManager.fetchReminders(userId);
-    if (rems.empty()) return BotResponse("No active reminders.");
+std::string BotManager::handleReminders() const {
+    if (!deps_.fetchReminders) return "Not available.";
+    auto rems = deps_.fetchReminders();
+    if (rems.empty()) return "No active reminders.";
     std::ostringstream oss;
     oss << "Reminders (" << rems.size() << "):\n";
     size_t idx = 1;
@@ -128,38 +356,98 @@ BotResponse BotManager::handleReminders(const std::string& userId) const {
         oss << idx++ << ") " << r.title
             << " - due: " << formatTimestamp(r.dueAt) << "\n";
     }
-    return BotResponse(oss.str());
+    return oss.str();
+}
+
+std::string BotManager::handleAddReminder(const std::string& title, std::chrono::minutes in) const {
+    if (!deps_.addReminder) return "Not available.";
+    if (title.empty() || in.count() <= 0) return "(args: title=text, minutes=N; cancel=id)";
+    Reminder reminder;
+    reminder.dueAt = std::chrono::system_clock::now() + in;
+    reminder.id = config_.userId + ":" +
+                  std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(
+                      reminder.dueAt.time_since_epoch()).count());
+    reminder.title = title;
+    if (!deps_.addReminder(reminder)) return "Could not save the reminder.";
+    return "Reminder set: " + title + " - due: " + formatTimestamp(reminder.dueAt) + " (id: " + reminder.id + ")";
+}
+
+std::string BotManager::handleCancelReminder(const std::string& reminderId) const {
+    if (!deps_.cancelReminder) return "Not available.";
+    return deps_.cancelReminder(reminderId) ? "Reminder cancelled." : "No such reminder.";
+}
+
+std::string BotManager::handleSettings(const std::unordered_map<std::string, std::string>& args) const {
+    std::ostringstream oss;
+    oss << "Settings:\n";
+    bool changed = false;
+    if (auto it = args.find("notifications"); it != args.end() && deps_.toggleNotifications) {
+        bool enabled = deps_.toggleNotifications(it->second == "on" || it->second == "1" || it->second == "true");
+        oss << "- Notifications: " << (enabled ? "on" : "off") << "\n";
+        changed = true;
+    }
+    if (auto it = args.find("status"); it != args.end() && deps_.setStatusText) {
+        deps_.setStatusText(it->second);
+        oss << "- Status: " << it->second << "\n";
+        changed = true;
+    }
+    if (!changed) {
+        oss << "(args: notifications=on|off, status=text)";
+    }
+    return oss.str();
 }
 
-BotResponse BotManager::handleStats(const std::string& userId) const {
-    Stats s = dbManager.fetchStats(userId);
+std::string BotManager::handleStats() const {
+    // The tracker answers in O(1) from running counters; fetchStats scans the history
+    Stats s;
+    if (statsTracker_ && !config_.userId.empty()) {
+        s = statsTracker_->snapshot(config_.userId);
+    } else if (deps_.fetchStats) {
+        s = deps_.fetchStats();
+    } else {
+        return "Not available.";
+    }
     std::ostringstream oss;
     oss << "Stats:\n"
         << "- Sent: " << s.sentCount << "\n"
         << "- Received: " << s.receivedCount << "\n";
     if (s.topContactId.has_value()) {
-        oss << "- Most interaction with: " << *s.topContactId << "\n";
+        oss << "- Most interaction with: " << *s.topContactId;
+        if (s.topContactCount.has_value()) oss << " (~" << *s.topContactCount << " messages)";
+        oss << "\n";
+    }
+    if (s.today.has_value()) {
+        oss << "- Today: " << s.today->sentCount << " sent, " << s.today->receivedCount << " received\n";
+    }
+    if (s.last7Days.has_value()) {
+        oss << "- Last 7 days: " << s.last7Days->sentCount << " sent, " << s.last7Days->receivedCount << " received\n";
     }
-    return BotResponse(oss.str());
+    if (s.thisWeek.has_value()) {
+        oss << "- This week: " << s.thisWeek->sentCount << " sent, " << s.thisWeek->receivedCount << " received\n";
+    }
+    return oss.str();
 }
 
-BotResponse BotManager::handleClearChatHistory(const std::string& userId) const {
-    dbManager.clearChatHistory(userId);
-    return BotResponse("Bot chat history cleared.");
+std::string BotManager::handleClearChatHistory() const {
+    if (!deps_.clearChatHistory) return "Not available.";
+    deps_.clearChatHistory();
+    return "Bot chat history cleared.";
 }
 
-BotResponse BotManager::handleHelp() const {
+std::string BotManager::handleHelp() const {
     std::ostringstream oss;
     oss << "Help:\n"
         << "1) Unread messages count\n"
         << "2) My profile\n"
-        << "3) Last messages (args: limit)\n"
-        << "4) Search messages (args: query, limit)\n"
-        << "5) Reminders\n"
-        << "6) Stats\n"
-        << "7) Clear chat history\n"
-        << "8) Help";
-    return BotResponse(oss.str());
+        << "3) Online contacts\n"
+        << "4) Last messages (args: limit)\n"
+        << "5) Search messages (args: query, limit)\n"
+        << "6) Reminders (args: title, minutes; cancel)\n"
+        << "7) Help\n"
+        << "8) Settings (args: notifications, status)\n"
+        << "9) Clear chat history\n"
+        << "10) Stats";
+    return oss.str();
 }
 
 // --- helpers ---
@@ -181,3 +469,31 @@ std::string BotManager::truncate(const std::string& s, size_t maxLen) {
     if (maxLen <= 3) return "...";
     return s.substr(0, maxLen - 3) + "...";
 }
+
+size_t BotManager::parseLimit(const std::unordered_map<std::string, std::string>& args, size_t fallback) {
+    size_t limit = fallback;
+    if (auto it = args.find("limit"); it != args.end()) {
+        try { limit = std::stoul(it->second); } catch (...) {}
+    }
+    return limit;
+}
+
+bool BotManager::changesState(int choice, const std::unordered_map<std::string, std::string>& args) {
+    return choice == static_cast<int>(MenuItem::Reminders) && (args.count("title") || args.count("cancel"));
+}
+
+const char* BotManager::commandName(int choice) {
+    switch (choice) {
+        case static_cast<int>(MenuItem::UnreadCount): return "unread_count";
+        case static_cast<int>(MenuItem::UserProfile): return "user_profile";
+        case static_cast<int>(MenuItem::OnlineContacts): return "online_contacts";
+        case static_cast<int>(MenuItem::LastMessages): return "last_messages";
+        case static_cast<int>(MenuItem::SearchMessages): return "search_messages";
+        case static_cast<int>(MenuItem::Reminders): return "reminders";
+        case static_cast<int>(MenuItem::Help): return "help";
+        case static_cast<int>(MenuItem::Settings): return "settings";
+        case static_cast<int>(MenuItem::ClearChatHistory): return "clear_chat_history";
+        case static_cast<int>(MenuItem::Stats): return "stats";
+        default: return "unknown";
+    }
+}
@@ -11,6 +11,14 @@
 #include <optional>
 #include <chrono>
 #include <unordered_map>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "BotExecutor.h"
+#include "BotResultCache.h"
+
+class UserStatsTracker;
 
 /**
  * @brief انواع آیتم‌های منوی ربات
@@ -60,6 +68,14 @@ struct Contact {
     bool isOnline = false;
 };
 
+/**
+ * @brief شمارش ارسال/دریافت در یک بازه‌ی زمانی
+ */
+struct PeriodStats {
+    size_t sentCount = 0;
+    size_t receivedCount = 0;
+};
+
 /**
  * @brief ساختار آمار کلی گفتگوها/کاربر
  */
@@ -67,6 +83,12 @@ struct Stats {
     size_t sentCount = 0;
     size_t receivedCount = 0;
     std::optional<std::string> topContactId; // بیشترین تعامل
+    // (اختیاری) تعداد پیام‌ها با topContactId؛ حداکثر به اندازه‌ی خطای تخمین بیشتر از مقدار واقعی
+    std::optional<size_t> topContactCount;
+    // (اختیاری) جمع‌های دوره‌ای (روز و هفته بر اساس UTC)
+    std::optional<PeriodStats> today;
+    std::optional<PeriodStats> last7Days;
+    std::optional<PeriodStats> thisWeek;
 };
 
 /**
@@ -99,6 +121,9 @@ struct BotManagerDeps {
 
     // یادآورها
     std::function<std::vector<Reminder>()> fetchReminders;
+    // ساخت/لغو یادآور (مثلاً ReminderScheduler::schedule / cancel)
+    std::function<bool(const Reminder&)> addReminder;
+    std::function<bool(const std::string& /*reminderId*/)> cancelReminder;
 
     // تنظیمات
     std::function<bool(bool /*enable*/)> toggleNotifications; // خروجی: وضعیت نهایی
@@ -131,6 +156,30 @@ struct BotManagerConfig {
     // محدودیت‌های پیش‌فرض
     size_t defaultLastMessagesLimit = 5;
     size_t defaultSearchLimit = 10;
+    // مهلت هر دستور ناهمگام؛ پس از آن هر آنچه آماده است برگردانده می‌شود
+    std::chrono::milliseconds commandDeadline{800};
+
+    // شناسه‌ی کاربر صاحب ربات؛ کش پاسخ‌ها فقط با آن فعال است
+    std::string userId;
+    // TTL کش برای هر دستور؛ دستورهایی که اینجا نیستند کش نمی‌شوند
+    std::unordered_map<int, std::chrono::milliseconds> cacheTtl = {
+        {static_cast<int>(MenuItem::UnreadCount), std::chrono::seconds(5)},
+        {static_cast<int>(MenuItem::UserProfile), std::chrono::seconds(60)},
+        {static_cast<int>(MenuItem::OnlineContacts), std::chrono::seconds(5)},
+        {static_cast<int>(MenuItem::LastMessages), std::chrono::seconds(10)},
+        {static_cast<int>(MenuItem::SearchMessages), std::chrono::seconds(30)},
+        {static_cast<int>(MenuItem::Reminders), std::chrono::seconds(30)},
+        {static_cast<int>(MenuItem::Stats), std::chrono::seconds(30)}
+    };
+};
+
+/**
+ * @brief پاسخ یک دستور ناهمگام
+ */
+struct BotReply {
+    std::string text;
+    bool complete = true;                   // false: مهلت تمام شد و text فقط بخش‌های آماده را دارد
+    std::chrono::microseconds latency{0};   // از ارسال تا آماده شدن پاسخ
 };
 
 /**
@@ -141,8 +190,21 @@ struct BotManagerConfig {
  */
 class BotManager {
 public:
+    /**
+     * @param executor استخر کارگر مشترک بین کاربران؛ اگر خالی باشد ربات استخر خودش را می‌سازد
+     * @param cache کش پاسخ‌ها (می‌تواند مشترک باشد)؛ اگر خالی باشد ربات کش خودش را می‌سازد
+     * @param statsTracker (اختیاری، می‌تواند مشترک باشد) با onMessageEvent پر می‌شود و اگر
+     *        config.userId تعیین شده باشد آمار از آن خوانده می‌شود، نه از deps.fetchStats
+     */
     explicit BotManager(BotManagerDeps deps,
-                        BotManagerConfig cfg = {});
+                        BotManagerConfig cfg = {},
+                        std::shared_ptr<BotExecutor> executor = nullptr,
+                        std::shared_ptr<BotResultCache> cache = nullptr,
+                        std::shared_ptr<UserStatsTracker> statsTracker = nullptr);
+    ~BotManager();  // منتظر دستورهای ناهمگامِ در حال اجرا می‌ماند
+
+    BotManager(const BotManager&) = delete;
+    BotManager& operator=(const BotManager&) = delete;
 
     /**
      * @brief متن منو را برمی‌گرداند (برای چاپ در UI)
@@ -158,6 +220,33 @@ public:
     std::string handleChoice(int choice,
                              const std::unordered_map<std::string, std::string>& args = {}) const;
 
+    /**
+     * @brief نسخه‌ی ناهمگام handleChoice: روی استخر کارگر اجرا می‌شود و نخ چت را نگه نمی‌دارد
+     * @return پاسخ، حداکثر پس از config().commandDeadline
+     */
+    std::future<BotReply> handleChoiceAsync(int choice,
+                                            const std::unordered_map<std::string, std::string>& args = {}) const;
+
+    /**
+     * @brief چند دستور مستقل را موازی اجرا می‌کند (مثلاً آمار + جستجو + آخرین پیام‌ها)
+     *
+     * بخش‌ها به ترتیب choices کنار هم قرار می‌گیرند. اگر مهلت تمام شود، بخش‌های آماده
+     * برگردانده می‌شوند و به جای بقیه یک پیام «تمام نشد» می‌آید (complete = false).
+     */
+    std::future<BotReply> handleChoicesAsync(const std::vector<int>& choices,
+                                             const std::unordered_map<std::string, std::string>& args = {}) const;
+
+    /**
+     * @brief هیستوگرام تأخیر هر دستور و آمار کش (فرمت متنی Prometheus)
+     */
+    std::string exportLatencyMetrics() const;
+
+    /**
+     * @brief باید برای هر پیام ارسال‌شده/خوانده‌شده صدا زده شود تا پاسخ‌های کش‌شده‌ی کهنه دور ریخته شوند
+     * @param isNewMessage برای پیام تازه true (در statsTracker شمرده می‌شود)؛ برای خوانده شدن false
+     */
+    void onMessageEvent(const std::string& fromUserId, const std::string& toUserId, bool isNewMessage = true) const;
+
     /**
      * @brief توابع شفاف برای هر قابلیت (در صورت نیاز مستقیم صدا بزنید)
      */
@@ -167,6 +256,8 @@ public:
     std::string handleLastMessages(size_t limit) const;
     std::string handleSearchMessages(const std::string& query, size_t limit) const;
     std::string handleReminders() const;
+    std::string handleAddReminder(const std::string& title, std::chrono::minutes in) const;
+    std::string handleCancelReminder(const std::string& reminderId) const;
     std::string handleHelp() const;
     std::string handleSettings(const std::unordered_map<std::string, std::string>& args) const;
     std::string handleClearChatHistory() const;
@@ -180,10 +271,29 @@ public:
 private:
     BotManagerDeps deps_;
     BotManagerConfig config_;
+    std::shared_ptr<BotExecutor> executor_;
+    std::shared_ptr<BotResultCache> cache_;
+    std::shared_ptr<UserStatsTracker> statsTracker_;
+
+    // دستورهای ناهمگامی که هنوز به this اشاره دارند
+    mutable std::mutex inFlightMutex_;
+    mutable std::condition_variable inFlightDone_;
+    mutable size_t inFlight_ = 0;
 
     // کمک‌کننده‌ها
     static std::string formatTimestamp(const std::chrono::system_clock::time_point& tp);
     static std::string truncate(const std::string& s, size_t maxLen);
+    static const char* commandName(int choice);
+    static size_t parseLimit(const std::unordered_map<std::string, std::string>& args, size_t fallback);
+    static bool changesState(int choice, const std::unordered_map<std::string, std::string>& args);
+
+    std::string runChoice(int choice, const std::unordered_map<std::string, std::string>& args) const;
+    // پاسخ کش‌شده اگر تازه باشد؛ در غیر این صورت ticket برای ذخیره‌ی بعدی پر می‌شود
+    std::optional<std::string> cachedReply(int choice, const std::unordered_map<std::string, std::string>& args,
+                                           BotResultCache::Ticket& ticket) const;
+    void storeReply(int choice, const std::unordered_map<std::string, std::string>& args,
+                    const std::string& text, const BotResultCache::Ticket& ticket) const;
+    std::string cacheArgsKey(int choice, const std::unordered_map<std::string, std::string>& args) const;
 };
 
 #endif // BOTMANAGER_H
@@ -0,0 +1,130 @@
+#include "BotResultCache.h"
+
+BotResultCache::BotResultCache(size_t maxBytes) : maxBytes_(maxBytes) {}
+
+std::string BotResultCache::makeKey(const std::string& userId, int command, const std::string& argsKey) {
+    return userId + '\x1f' + std::to_string(command) + '\x1f' + argsKey;
+}
+
+std::optional<std::string> BotResultCache::get(const std::string& userId, int command, const std::string& argsKey,
+                                               Ticket& ticket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ticket = current(userId);
+    size_t slot = command >= 0 && static_cast<size_t>(command) < kMaxCommands ? static_cast<size_t>(command) : 0;
+
+    auto found = index_.find(makeKey(userId, command, argsKey));
+    if (found != index_.end()) {
+        auto it = found->second;
+        bool stale = it->generation.all != ticket.all ||
+                     (it->dependsOnMessages && it->generation.messages != ticket.messages);
+        if (stale) {
+            counters_.invalidated++;
+            erase(it);
+        } else if (it->expiresAt <= Clock::now()) {
+            counters_.expired++;
+            erase(it);
+        } else {
+            lru_.splice(lru_.begin(), lru_, it);
+            counters_.hits++;
+            counters_.commandHits[slot]++;
+            return it->text;
+        }
+    }
+    counters_.misses++;
+    counters_.commandMisses[slot]++;
+    return std::nullopt;
+}
+
+void BotResultCache::put(const std::string& userId, int command, const std::string& argsKey, const std::string& text,
+                         std::chrono::milliseconds ttl, bool dependsOnMessages, const Ticket& ticket) {
+    std::string key = makeKey(userId, command, argsKey);
+    size_t bytes = key.size() * 2 + text.size() + sizeof(Entry) + 64;   // Rough: list node + map node
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Invalidated while the handler ran: the result may already be out of date
+    const Ticket& now = current(userId);
+    if (now.all != ticket.all || (dependsOnMessages && now.messages != ticket.messages)) {
+        return;
+    }
+    if (bytes > maxBytes_) {
+        return;
+    }
+
+    if (auto found = index_.find(key); found != index_.end()) {
+        erase(found->second);
+    }
+    Generation& owner = record(userId);
+    if (owner.entries++ == 0) {
+        usersWithEntries_++;
+    }
+    lru_.push_front({key, text, Clock::now() + ttl, dependsOnMessages, ticket, bytes, &owner});
+    index_[key] = lru_.begin();
+    bytes_ += bytes;
+
+    while (bytes_ > maxBytes_) {
+        erase(std::prev(lru_.end()));
+        counters_.evictions++;
+    }
+}
+
+void BotResultCache::invalidateMessages(const std::string& userId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    record(userId).ticket.messages = ++clock_;
+}
+
+void BotResultCache::invalidateUser(const std::string& userId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    record(userId).ticket.all = ++clock_;
+}
+
+BotResultCache::Stats BotResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats result = counters_;
+    result.entries = lru_.size();
+    result.bytes = bytes_;
+    result.users = generations_.size();
+    return result;
+}
+
+void BotResultCache::erase(std::list<Entry>::iterator it) {
+    if (--it->owner->entries == 0) {
+        usersWithEntries_--;
+        // Not invalidated since it was created: absent_ says the same, so the record can go now.
+        // Others wait for sweep(), which renumbers absent_ once for all of them.
+        const Ticket& ticket = it->owner->ticket;
+        if (ticket.messages == absent_.messages && ticket.all == absent_.all) {
+            generations_.erase(it->key.substr(0, it->key.find('\x1f')));
+        }
+    }
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+const BotResultCache::Ticket& BotResultCache::current(const std::string& userId) const {
+    auto found = generations_.find(userId);
+    return found != generations_.end() ? found->second.ticket : absent_;
+}
+
+BotResultCache::Generation& BotResultCache::record(const std::string& userId) {
+    auto found = generations_.find(userId);
+    if (found != generations_.end()) {
+        return found->second;
+    }
+    if (generations_.size() >= usersWithEntries_ * 2 + kSweepSlack) {
+        sweep();
+    }
+    return generations_.emplace(userId, Generation{absent_, 0}).first->second;
+}
+
+void BotResultCache::sweep() {
+    for (auto it = generations_.begin(); it != generations_.end();) {
+        if (it->second.entries == 0) {
+            it = generations_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // Swept users now read absent_: give it a fresh number so their older tickets no longer match
+    absent_.messages = absent_.all = ++clock_;
+}
@@ -0,0 +1,97 @@
+#ifndef BOTRESULTCACHE_H
+#define BOTRESULTCACHE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief کش پاسخ دستورهای ربات برای هر کاربر، با TTL و سقف حافظه (LRU)
+ *
+ * می‌تواند بین ربات‌های همه‌ی کاربران مشترک باشد تا سقف حافظه کلی باشد.
+ * باطل‌سازی O(1) است: هر کاربر یک شماره‌ی نسل دارد و ورودی‌های نسل قدیمی
+ * هنگام خواندن کنار گذاشته می‌شوند (و با LRU از حافظه بیرون می‌روند).
+ * شماره‌ها از یک شمارنده‌ی سراسری می‌آیند و هرگز تکرار نمی‌شوند؛ کاربری که رکورد
+ * نسل ندارد نسل absent_ را دارد. رکورد کاربرانی که ورودی در کش ندارند دسته‌جمعی
+ * پاک می‌شود، پس تعداد رکوردها با تعداد کاربران دارای ورودی محدود می‌ماند.
+ */
+class BotResultCache {
+public:
+    static constexpr size_t kMaxCommands = 16;
+    static constexpr size_t kSweepSlack = 1024;    // Records without entries allowed before a sweep
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t expired = 0;       // Found but past its TTL
+        uint64_t invalidated = 0;   // Found but older than an invalidation
+        uint64_t evictions = 0;     // Dropped to stay under maxBytes
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t users = 0;           // Users with a generation record
+        std::array<uint64_t, kMaxCommands> commandHits{};
+        std::array<uint64_t, kMaxCommands> commandMisses{};
+    };
+
+    // Generations current when a lookup missed; put() drops results computed before a later invalidation
+    struct Ticket {
+        uint64_t messages = 0;
+        uint64_t all = 0;
+    };
+
+    explicit BotResultCache(size_t maxBytes = 8 << 20);
+
+    std::optional<std::string> get(const std::string& userId, int command, const std::string& argsKey,
+                                   Ticket& ticket);
+    void put(const std::string& userId, int command, const std::string& argsKey, const std::string& text,
+             std::chrono::milliseconds ttl, bool dependsOnMessages, const Ticket& ticket);
+
+    // A message to or from userId was sent, read or edited: drops its message-derived results
+    void invalidateMessages(const std::string& userId);
+    // Drops everything cached for userId (settings changed, history cleared)
+    void invalidateUser(const std::string& userId);
+
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Generation {
+        Ticket ticket;
+        size_t entries = 0;     // Cached results of this user
+    };
+
+    struct Entry {
+        std::string key;
+        std::string text;
+        Clock::time_point expiresAt;
+        bool dependsOnMessages;
+        Ticket generation;
+        size_t bytes;
+        Generation* owner;      // References into generations_ stay valid across rehashing
+    };
+
+    mutable std::mutex mutex_;
+    size_t maxBytes_;
+    size_t bytes_ = 0;
+    std::list<Entry> lru_;     // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::unordered_map<std::string, Generation> generations_;
+    size_t usersWithEntries_ = 0;
+    uint64_t clock_ = 0;        // Source of generation numbers
+    Ticket absent_;             // Generation of users without a record in generations_
+    Stats counters_;
+
+    static std::string makeKey(const std::string& userId, int command, const std::string& argsKey);
+    void erase(std::list<Entry>::iterator it);     // Call with mutex_ held
+    const Ticket& current(const std::string& userId) const;    // Call with mutex_ held
+    Generation& record(const std::string& userId);             // Call with mutex_ held; creates it if needed
+    void sweep();                                              // Call with mutex_ held
+};
+
+#endif // BOTRESULTCACHE_H
@@ -0,0 +1,206 @@
+#include "ReminderScheduler.h"
+#include <algorithm>
+
+namespace {
+uint64_t epochMs(std::chrono::system_clock::time_point tp) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    return ms > 0 ? static_cast<uint64_t>(ms) : 0;
+}
+}
+
+ReminderScheduler::ReminderScheduler(ReminderSchedulerDeps deps, ReminderSchedulerConfig cfg)
+    : deps_(std::move(deps)), config_(cfg),
+      wheel_(epochMs(std::chrono::system_clock::now()) /
+             static_cast<uint64_t>(std::max<int64_t>(cfg.tick.count(), 1))) {
+    if (config_.tick.count() < 1) config_.tick = std::chrono::milliseconds(1);
+}
+
+ReminderScheduler::~ReminderScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (timerThread_.joinable()) {
+        timerThread_.join();
+    }
+}
+
+std::string ReminderScheduler::formatMessage(const Reminder& reminder) {
+    return "⏰ Reminder: " + reminder.title;
+}
+
+uint64_t ReminderScheduler::tickOf(std::chrono::system_clock::time_point tp) const {
+    uint64_t tick = static_cast<uint64_t>(config_.tick.count());
+    return (epochMs(tp) + tick - 1) / tick;
+}
+
+// --- scheduling ---
+size_t ReminderScheduler::recover() {
+    if (!deps_.loadReminders) return 0;
+    auto stored = deps_.loadReminders();
+    size_t recovered = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [userId, reminder] : stored) {
+            if (reminder.id.empty() || byId_.count(reminder.id)) continue;
+            insertLocked(userId, reminder, tickOf(reminder.dueAt), 0);   // Overdue ones fire on the next tick
+            recovered++;
+        }
+    }
+    wake_.notify_one();
+    return recovered;
+}
+
+void ReminderScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!timerThread_.joinable() && !stopping_) {
+        timerThread_ = std::thread(&ReminderScheduler::timerLoop, this);
+    }
+}
+
+bool ReminderScheduler::schedule(const std::string& userId, const Reminder& reminder) {
+    if (reminder.id.empty()) return false;
+    {
+        // The row is written under the lock, so a concurrent delivery cannot delete it after the save
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (deps_.saveReminder && !deps_.saveReminder(userId, reminder)) return false;
+        if (auto found = byId_.find(reminder.id); found != byId_.end()) {
+            wheel_.cancel(entries_[found->second].handle);
+            takeLocked(found->second);
+        }
+        insertLocked(userId, reminder, tickOf(reminder.dueAt), 0);
+        counters_.scheduled++;
+    }
+    wake_.notify_one();
+    if (deps_.remindersChanged) deps_.remindersChanged(userId);
+    return true;
+}
+
+bool ReminderScheduler::cancel(const std::string& reminderId) {
+    std::string userId;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = byId_.find(reminderId);
+        if (found == byId_.end()) return false;
+        wheel_.cancel(entries_[found->second].handle);
+        userId = takeLocked(found->second).userId;
+        if (deps_.deleteReminder) deps_.deleteReminder(reminderId);
+        counters_.cancelled++;
+    }
+    if (deps_.remindersChanged) deps_.remindersChanged(userId);
+    return true;
+}
+
+std::vector<Reminder> ReminderScheduler::pending(const std::string& userId) const {
+    std::vector<Reminder> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = byUser_.find(userId);
+        if (found == byUser_.end()) return result;
+        result.reserve(found->second.size());
+        for (uint32_t index : found->second) {
+            result.push_back(entries_[index].reminder);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Reminder& a, const Reminder& b) { return a.dueAt < b.dueAt; });
+    return result;
+}
+
+ReminderScheduler::Stats ReminderScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats result = counters_;
+    result.pending = byId_.size();
+    return result;
+}
+
+// --- firing ---
+size_t ReminderScheduler::runDue(std::chrono::system_clock::time_point now) {
+    std::vector<Entry> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<uint64_t> expired;
+        wheel_.advance(epochMs(now) / static_cast<uint64_t>(config_.tick.count()), expired);
+        due.reserve(expired.size());
+        for (uint64_t index : expired) {
+            due.push_back(takeLocked(static_cast<uint32_t>(index)));
+        }
+    }
+
+    // Delivery writes to the chat; it must not block schedule/cancel
+    size_t delivered = 0;
+    for (auto& entry : due) {
+        bool ok = deps_.deliver && deps_.deliver(entry.userId, formatMessage(entry.reminder), entry.reminder);
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool replaced = byId_.count(entry.reminder.id) > 0;     // Rescheduled while being delivered
+        if (ok) {
+            if (!replaced && deps_.deleteReminder) deps_.deleteReminder(entry.reminder.id);
+            counters_.delivered++;
+            delivered++;
+        } else {
+            counters_.failedAttempts++;
+            if (entry.attempts + 1 >= config_.maxAttempts) {
+                counters_.dropped++;    // Its row stays, so the next recover() tries again
+            } else if (!replaced) {
+                insertLocked(entry.userId, entry.reminder, tickOf(now + config_.retryDelay), entry.attempts + 1);
+            }
+        }
+    }
+    if (deps_.remindersChanged) {
+        for (const auto& entry : due) {
+            deps_.remindersChanged(entry.userId);
+        }
+    }
+    return delivered;
+}
+
+void ReminderScheduler::timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (wheel_.size() == 0) {
+            wake_.wait(lock, [this] { return stopping_ || wheel_.size() > 0; });
+            continue;
+        }
+        auto nextTick = std::chrono::system_clock::time_point(
+            std::chrono::milliseconds((wheel_.now() + 1) * static_cast<uint64_t>(config_.tick.count())));
+        if (wake_.wait_until(lock, nextTick, [this] { return stopping_; })) {
+            break;
+        }
+        lock.unlock();
+        runDue(std::chrono::system_clock::now());
+        lock.lock();
+    }
+}
+
+// --- entries ---
+void ReminderScheduler::insertLocked(const std::string& userId, const Reminder& reminder, uint64_t dueTick,
+                                     int attempts) {
+    uint32_t index;
+    if (!freeEntries_.empty()) {
+        index = freeEntries_.back();
+        freeEntries_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+    Entry& entry = entries_[index];
+    entry.userId = userId;
+    entry.reminder = reminder;
+    entry.handle = wheel_.insert(dueTick, index);
+    entry.attempts = attempts;
+    byId_[reminder.id] = index;
+    byUser_[userId].insert(index);
+}
+
+ReminderScheduler::Entry ReminderScheduler::takeLocked(uint32_t index) {
+    Entry entry = std::move(entries_[index]);
+    entries_[index] = Entry{};
+    byId_.erase(entry.reminder.id);
+    auto user = byUser_.find(entry.userId);
+    if (user != byUser_.end()) {
+        user->second.erase(index);
+        if (user->second.empty()) byUser_.erase(user);
+    }
+    freeEntries_.push_back(index);
+    return entry;
+}
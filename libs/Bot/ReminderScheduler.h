@@ -0,0 +1,141 @@
+#ifndef REMINDERSCHEDULER_H
+#define REMINDERSCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "BotManager.h"
+#include "TimingWheel.h"
+
+/**
+ * @brief وابستگی‌های زمان‌بند یادآور (ذخیره‌سازی و تحویل پیام ربات)
+ */
+struct ReminderSchedulerDeps {
+    // ذخیره/حذف رکورد یادآور؛ رکورد تا تحویل یا لغو باقی می‌ماند
+    std::function<bool(const std::string& /*userId*/, const Reminder&)> saveReminder;
+    std::function<void(const std::string& /*reminderId*/)> deleteReminder;
+
+    // بارگذاری همه‌ی یادآورهای ذخیره‌شده هنگام شروع (userId, reminder)
+    std::function<std::vector<std::pair<std::string, Reminder>>()> loadReminders;
+
+    // فرستادن پیام ربات به چت کاربر؛ false یعنی بعداً دوباره تلاش شود
+    std::function<bool(const std::string& /*userId*/, const std::string& /*text*/, const Reminder&)> deliver;
+
+    // (اختیاری) پس از هر تغییر در یادآورهای کاربر، مثلاً برای باطل کردن پاسخ کش‌شده‌ی ربات
+    std::function<void(const std::string& /*userId*/)> remindersChanged;
+};
+
+/**
+ * @brief پیکربندی زمان‌بند یادآور
+ */
+struct ReminderSchedulerConfig {
+    std::chrono::milliseconds tick{100};            // دقت زمان‌بندی
+    std::chrono::milliseconds retryDelay{30000};    // فاصله‌ی تلاش دوباره پس از تحویل ناموفق
+    int maxAttempts = 5;                            // پس از آن تا شروع بعدی (recover) رها می‌شود
+};
+
+/**
+ * @brief زمان‌بند یادآورها روی یک چرخ زمان‌سنج سلسله‌مراتبی
+ *
+ * همه‌ی یادآورهای همه‌ی کاربران در یک TimingWheel نگه داشته می‌شوند؛ افزودن و لغو O(1)
+ * است و یک نخ زمان‌سنج در هر تیک یادآورهای سررسیده را بیرون می‌کشد و بیرون از قفل
+ * تحویل می‌دهد. پس از تحویل موفق رکورد پایگاه داده حذف می‌شود، پس یادآوری که هنگام
+ * خاموشی در راه بوده با recover() دوباره زمان‌بندی می‌شود (حداقل یک بار تحویل).
+ * Thread-safe.
+ */
+class ReminderScheduler {
+public:
+    struct Stats {
+        size_t pending = 0;
+        uint64_t scheduled = 0;
+        uint64_t cancelled = 0;
+        uint64_t delivered = 0;
+        uint64_t failedAttempts = 0;
+        uint64_t dropped = 0;       // بیش از maxAttempts ناموفق
+    };
+
+    explicit ReminderScheduler(ReminderSchedulerDeps deps, ReminderSchedulerConfig cfg = {});
+    ~ReminderScheduler();   // نخ زمان‌سنج را متوقف می‌کند؛ یادآورهای باقی‌مانده در پایگاه داده می‌مانند
+
+    ReminderScheduler(const ReminderScheduler&) = delete;
+    ReminderScheduler& operator=(const ReminderScheduler&) = delete;
+
+    /**
+     * @brief یادآورهای ذخیره‌شده را بارگذاری می‌کند؛ آن‌هایی که موعدشان گذشته در اولین تیک تحویل می‌شوند
+     * @return تعداد یادآورهای بازیابی‌شده
+     */
+    size_t recover();
+
+    /**
+     * @brief نخ زمان‌سنج را راه می‌اندازد (بدون آن فقط runDue یادآورها را تحویل می‌دهد)
+     */
+    void start();
+
+    /**
+     * @brief ذخیره و زمان‌بندی؛ یادآور هم‌شناسه جایگزین می‌شود
+     * @return false اگر شناسه خالی باشد یا ذخیره ناموفق شود
+     */
+    bool schedule(const std::string& userId, const Reminder& reminder);
+
+    /**
+     * @brief لغو یادآور؛ false اگر وجود نداشته یا در حال تحویل باشد
+     */
+    bool cancel(const std::string& reminderId);
+
+    /**
+     * @brief یادآورهای در انتظار یک کاربر به ترتیب موعد (برای fetchReminders ربات)
+     */
+    std::vector<Reminder> pending(const std::string& userId) const;
+
+    /**
+     * @brief هر یادآوری را که تا now سررسیده تحویل می‌دهد (نخ زمان‌سنج همین را صدا می‌زند)
+     * @return تعداد یادآورهای تحویل‌شده
+     */
+    size_t runDue(std::chrono::system_clock::time_point now);
+
+    Stats stats() const;
+
+    /**
+     * @brief متن پیام ربات برای یک یادآور سررسیده
+     */
+    static std::string formatMessage(const Reminder& reminder);
+
+private:
+    struct Entry {
+        std::string userId;
+        Reminder reminder;
+        TimingWheel::Handle handle = 0;
+        int attempts = 0;
+    };
+
+    ReminderSchedulerDeps deps_;
+    ReminderSchedulerConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    TimingWheel wheel_;
+    std::vector<Entry> entries_;                    // Indexed by wheel payload
+    std::vector<uint32_t> freeEntries_;
+    std::unordered_map<std::string, uint32_t> byId_;
+    std::unordered_map<std::string, std::unordered_set<uint32_t>> byUser_;
+    Stats counters_;
+
+    std::thread timerThread_;
+    bool stopping_ = false;
+
+    uint64_t tickOf(std::chrono::system_clock::time_point tp) const;   // Rounded up: never fires early
+    // Callers hold mutex_
+    void insertLocked(const std::string& userId, const Reminder& reminder, uint64_t dueTick, int attempts);
+    Entry takeLocked(uint32_t index);
+    void timerLoop();
+};
+
+#endif // REMINDERSCHEDULER_H
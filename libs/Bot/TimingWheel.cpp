@@ -0,0 +1,116 @@
+#include "TimingWheel.h"
+
+TimingWheel::TimingWheel(uint64_t startTick) : now_(startTick) {}
+
+size_t TimingWheel::memoryUsage() const {
+    size_t bytes = sizeof(*this) + (generations_.capacity() + freeIds_.capacity()) * sizeof(uint32_t);
+    for (const auto& list : lists_) {
+        bytes += list.capacity() * sizeof(Timer);
+    }
+    return bytes;
+}
+
+TimingWheel::Handle TimingWheel::insert(uint64_t dueTick, uint64_t payload) {
+    uint32_t id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        id = static_cast<uint32_t>(generations_.size());
+        generations_.push_back(0);
+    }
+    uint64_t due = dueTick > now_ ? dueTick : now_ + 1;    // The current tick has already been processed
+    place(Timer{due, payload, id, generations_[id]});
+    size_++;
+    return (static_cast<uint64_t>(generations_[id]) << 32) | (static_cast<uint64_t>(id) + 1);
+}
+
+bool TimingWheel::cancel(Handle handle) {
+    uint64_t slot = handle & 0xFFFFFFFFu;
+    if (slot == 0 || slot > generations_.size()) return false;
+    uint32_t id = static_cast<uint32_t>(slot - 1);
+    if (generations_[id] != static_cast<uint32_t>(handle >> 32)) return false;
+    finish(id);     // Its entry stays in the list until that list is cascaded or fired
+    return true;
+}
+
+void TimingWheel::advance(uint64_t tick, std::vector<uint64_t>& expired) {
+    while (now_ < tick) {
+        if (size_ == 0) {
+            // Only cancelled entries are left: drop them and jump
+            for (int level = 0; level <= kLevels; level++) {
+                if (levelCounts_[level] == 0) continue;
+                uint32_t first = static_cast<uint32_t>(level) * kSlots;
+                uint32_t last = level == kLevels ? kOverflow : first + kSlots - 1;
+                for (uint32_t list = first; list <= last; list++) {
+                    std::vector<Timer>().swap(lists_[list]);
+                }
+                levelCounts_[level] = 0;
+            }
+            now_ = tick;
+            return;
+        }
+        // Levels below the lowest occupied one are empty: nothing happens until its next block starts
+        int lowest = 0;
+        while (lowest < kLevels && levelCounts_[lowest] == 0) lowest++;
+        if (lowest > 0) {
+            int shift = kSlotBits * (lowest < kLevels ? lowest : kLevels - 1);
+            uint64_t beforeBoundary = (((now_ >> shift) + 1) << shift) - 1;
+            if (beforeBoundary > now_) {
+                now_ = beforeBoundary < tick ? beforeBoundary : tick;
+                continue;
+            }
+        }
+        now_++;
+        // Entering a new block of a level: bring that block's timers one level down, top level first
+        for (int level = kLevels - 1; level >= 1; level--) {
+            uint64_t mask = (uint64_t{1} << (kSlotBits * level)) - 1;
+            if ((now_ & mask) == 0) {
+                if (level == kLevels - 1) {
+                    cascade(kOverflow);
+                }
+                cascade(static_cast<uint32_t>(level) * kSlots +
+                        static_cast<uint32_t>((now_ >> (kSlotBits * level)) & (kSlots - 1)));
+            }
+        }
+
+        std::vector<Timer> due;
+        due.swap(lists_[now_ & (kSlots - 1)]);
+        levelCounts_[0] -= due.size();
+        for (const Timer& timer : due) {
+            if (!live(timer)) continue;
+            expired.push_back(timer.payload);
+            finish(timer.id);
+        }
+    }
+}
+
+void TimingWheel::finish(uint32_t id) {
+    generations_[id]++;
+    freeIds_.push_back(id);
+    size_--;
+}
+
+void TimingWheel::place(const Timer& timer) {
+    // Lowest level whose parent block holds both due and now
+    for (int level = 0; level < kLevels; level++) {
+        int parentShift = kSlotBits * (level + 1);
+        if ((timer.due >> parentShift) == (now_ >> parentShift)) {
+            uint32_t slot = static_cast<uint32_t>((timer.due >> (kSlotBits * level)) & (kSlots - 1));
+            lists_[static_cast<uint32_t>(level) * kSlots + slot].push_back(timer);
+            levelCounts_[level]++;
+            return;
+        }
+    }
+    lists_[kOverflow].push_back(timer);
+    levelCounts_[kLevels]++;
+}
+
+void TimingWheel::cascade(uint32_t list) {
+    std::vector<Timer> moving;
+    moving.swap(lists_[list]);      // Also releases the list's memory
+    levelCounts_[list / kSlots] -= moving.size();
+    for (const Timer& timer : moving) {
+        place(timer);   // Stale ones too: checking costs a random read per timer, dropping them waits for firing
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief چرخ زمان‌سنج سلسله‌مراتبی (۴ سطح × ۲۵۶ خانه) برای میلیون‌ها زمان‌سنج
+ *
+ * افزودن و لغو O(1) است. زمان بر حسب «تیک» است و فقط جلو می‌رود. یک زمان‌سنج در
+ * پایین‌ترین سطحی قرار می‌گیرد که موعدش با «اکنون» در یک بلوک از سطح بالاتر باشد؛
+ * وقتی اکنون به بلوک آن برسد، یک سطح پایین‌تر می‌آید (cascade) و در تیک موعد دقیقاً
+ * یک بار منقضی می‌شود. موعدهای دورتر از 2^32 تیک در فهرست سرریز می‌مانند.
+ * هر خانه یک آرایه‌ی پیوسته است تا cascade پیمایش ترتیبی باشد، نه دنبال کردن اشاره‌گر؛
+ * لغو فقط نسل شناسه را عوض می‌کند و رکورد کهنه در تیک موعدش دور ریخته می‌شود.
+ * وقتی سطح‌های پایین خالی‌اند، advance تا مرز بلوک بعدی می‌پرد، پس جهش‌های بلند ارزان‌اند.
+ * Not thread-safe.
+ */
+class TimingWheel {
+public:
+    using Handle = uint64_t;    // 0 is never a valid handle
+
+    explicit TimingWheel(uint64_t startTick = 0);
+
+    // A due tick at or before now() fires on the next advance()
+    Handle insert(uint64_t dueTick, uint64_t payload);
+    // False if the timer already fired or was cancelled
+    bool cancel(Handle handle);
+    // Moves time forward to tick and appends the payload of every timer due by then, earliest first
+    void advance(uint64_t tick, std::vector<uint64_t>& expired);
+
+    uint64_t now() const { return now_; }
+    size_t size() const { return size_; }
+    size_t memoryUsage() const;
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kOverflow = kLevels * kSlots;     // Index of the overflow list
+
+    struct Timer {
+        uint64_t due;
+        uint64_t payload;
+        uint32_t id;
+        uint32_t generation;    // Stale once generations_[id] moves on (fired or cancelled)
+    };
+
+    std::array<std::vector<Timer>, kLevels * kSlots + 1> lists_;    // Last one is the overflow list
+    std::array<size_t, kLevels + 1> levelCounts_{};     // Entries per level (last: overflow), to skip empty stretches
+    std::vector<uint32_t> generations_;                 // Per id; bumped when its timer ends
+    std::vector<uint32_t> freeIds_;
+    uint64_t now_;
+    size_t size_ = 0;       // Live timers only
+
+    bool live(const Timer& timer) const { return generations_[timer.id] == timer.generation; }
+    void finish(uint32_t id);       // Ends a live timer and frees its id
+    void place(const Timer& timer); // Appends a timer to the list its due tick belongs to
+    void cascade(uint32_t list);    // Re-places every entry of a list relative to now_
+};
+
+#endif // TIMINGWHEEL_H
@@ -0,0 +1,146 @@
+#include "UserStatsTracker.h"
+#include <algorithm>
+#include <functional>
+
+// --- space saving ---
+SpaceSaving::SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+    counters_.reserve(capacity_);
+}
+
+void SpaceSaving::add(const std::string& key) {
+    size_t slot = counters_.size();
+    size_t smallest = 0;
+    for (size_t i = 0; i < counters_.size(); i++) {
+        if (counters_[i].key == key) {
+            slot = i;
+            break;
+        }
+        if (counters_[i].count < counters_[smallest].count) smallest = i;
+    }
+
+    if (slot < counters_.size()) {
+        counters_[slot].count++;
+    } else if (counters_.size() < capacity_) {
+        counters_.push_back({key, 1, 0});
+    } else {
+        // Full: the new key takes over the smallest counter and inherits its count as error
+        slot = smallest;
+        Counter& victim = counters_[slot];
+        victim.key = key;
+        victim.error = victim.count;
+        victim.count++;
+    }
+    // Counts only grow, so the top can only be overtaken by the counter just bumped
+    if (counters_[slot].count > counters_[top_].count) top_ = slot;
+}
+
+std::vector<SpaceSaving::Counter> SpaceSaving::topK() const {
+    std::vector<Counter> result = counters_;
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Counter& a, const Counter& b) { return a.count > b.count; });
+    return result;
+}
+
+// --- tracker ---
+UserStatsTracker::UserStatsTracker(size_t topContactsCapacity) : topContactsCapacity_(topContactsCapacity) {}
+
+UserStatsTracker::Shard& UserStatsTracker::shardFor(const std::string& userId) {
+    return shards_[std::hash<std::string>{}(userId) % kShards];
+}
+
+const UserStatsTracker::Shard& UserStatsTracker::shardFor(const std::string& userId) const {
+    return shards_[std::hash<std::string>{}(userId) % kShards];
+}
+
+int64_t UserStatsTracker::dayOf(std::chrono::system_clock::time_point tp) {
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+    int64_t day = seconds / 86400;
+    return seconds < 0 && seconds % 86400 != 0 ? day - 1 : day;
+}
+
+void UserStatsTracker::addTo(std::array<Bucket, kBuckets>& ring, int64_t period, bool sent) {
+    int64_t buckets = static_cast<int64_t>(kBuckets);
+    Bucket& bucket = ring[static_cast<size_t>(((period % buckets) + buckets) % buckets)];
+    if (bucket.period < period) {
+        bucket.period = period;     // The slot held a period that has rolled out of the ring
+        bucket.counts = PeriodStats{};
+    } else if (bucket.period > period) {
+        return;                     // Older than anything the ring keeps
+    }
+    (sent ? bucket.counts.sentCount : bucket.counts.receivedCount)++;
+}
+
+PeriodStats UserStatsTracker::sumOf(const std::array<Bucket, kBuckets>& ring, int64_t from, int64_t to) {
+    PeriodStats sum;
+    for (const Bucket& bucket : ring) {
+        if (bucket.period >= from && bucket.period <= to) {
+            sum.sentCount += bucket.counts.sentCount;
+            sum.receivedCount += bucket.counts.receivedCount;
+        }
+    }
+    return sum;
+}
+
+void UserStatsTracker::recordOne(const std::string& userId, const std::string& contactId, bool sent, int64_t day) {
+    Shard& shard = shardFor(userId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.users.find(userId);
+    if (it == shard.users.end()) {
+        it = shard.users.emplace(userId, UserStats(topContactsCapacity_)).first;
+    }
+    UserStats& stats = it->second;
+    (sent ? stats.sent : stats.received)++;
+    addTo(stats.days, day, sent);
+    addTo(stats.weeks, weekOf(day), sent);
+    stats.contacts.add(contactId);
+}
+
+void UserStatsTracker::record(const std::string& fromUserId, const std::string& toUserId,
+                              std::chrono::system_clock::time_point timestamp) {
+    int64_t day = dayOf(timestamp);
+    recordOne(fromUserId, toUserId, true, day);
+    if (toUserId != fromUserId) {
+        recordOne(toUserId, fromUserId, false, day);
+    }
+}
+
+Stats UserStatsTracker::snapshot(const std::string& userId, std::chrono::system_clock::time_point now) const {
+    int64_t today = dayOf(now);
+    Stats result;
+    result.today = PeriodStats{};
+    result.last7Days = PeriodStats{};
+    result.thisWeek = PeriodStats{};
+
+    const Shard& shard = shardFor(userId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.users.find(userId);
+    if (it == shard.users.end()) return result;
+    const UserStats& stats = it->second;
+
+    result.sentCount = stats.sent;
+    result.receivedCount = stats.received;
+    if (const SpaceSaving::Counter* top = stats.contacts.top()) {
+        result.topContactId = top->key;
+        result.topContactCount = static_cast<size_t>(top->count);
+    }
+    result.today = sumOf(stats.days, today, today);
+    result.last7Days = sumOf(stats.days, today - 6, today);
+    result.thisWeek = sumOf(stats.weeks, weekOf(today), weekOf(today));
+    return result;
+}
+
+std::vector<SpaceSaving::Counter> UserStatsTracker::topContacts(const std::string& userId) const {
+    const Shard& shard = shardFor(userId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.users.find(userId);
+    return it == shard.users.end() ? std::vector<SpaceSaving::Counter>{} : it->second.contacts.topK();
+}
+
+size_t UserStatsTracker::userCount() const {
+    size_t count = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.users.size();
+    }
+    return count;
+}
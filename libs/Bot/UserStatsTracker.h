@@ -0,0 +1,102 @@
+#ifndef USERSTATSTRACKER_H
+#define USERSTATSTRACKER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BotManager.h"
+
+/**
+ * @brief شمارنده‌ی Space-Saving برای پرتکرارترین مخاطبان با حافظه‌ی ثابت
+ *
+ * k شمارنده نگه می‌دارد. هر مخاطبی که بیش از n/k بار دیده شود حتماً در فهرست است و
+ * شمارش هر ورودی حداکثر به اندازه‌ی error بیشتر از مقدار واقعی است.
+ */
+class SpaceSaving {
+public:
+    struct Counter {
+        std::string key;
+        uint64_t count = 0;
+        uint64_t error = 0;     // Upper bound on how much count overestimates
+    };
+
+    explicit SpaceSaving(size_t capacity = 16);
+
+    void add(const std::string& key);
+    // Highest count, in O(1); nullptr before the first add
+    const Counter* top() const { return counters_.empty() ? nullptr : &counters_[top_]; }
+    // Counters by descending count
+    std::vector<Counter> topK() const;
+
+private:
+    size_t capacity_;
+    std::vector<Counter> counters_;     // Small and fixed size: a linear scan beats a map
+    size_t top_ = 0;
+};
+
+/**
+ * @brief آمار ارسال/دریافت هر کاربر که با جریان پیام‌ها به‌روز می‌شود
+ *
+ * به جای COUNT(*) و پیمایش کل تاریخچه، هر پیام یک بار با record() ثبت می‌شود:
+ * شمارنده‌های دقیق کل، سطل‌های روزانه (۸ روز اخیر) و هفتگی (۸ هفته‌ی اخیر) و یک
+ * SpaceSaving برای مخاطب اصلی. snapshot() مستقل از حجم تاریخچه O(1) است.
+ * در شروع برنامه کافی است تاریخچه‌ی موجود یک بار با record() بازپخش شود.
+ * Thread-safe (کاربران در چند shard با قفل جدا).
+ */
+class UserStatsTracker {
+public:
+    explicit UserStatsTracker(size_t topContactsCapacity = 16);
+
+    // A message from fromUserId to toUserId; late events still count in totals and in
+    // any bucket that is still kept
+    void record(const std::string& fromUserId, const std::string& toUserId,
+                std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now());
+
+    Stats snapshot(const std::string& userId,
+                   std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const;
+    // Estimated top contacts of a user by descending count
+    std::vector<SpaceSaving::Counter> topContacts(const std::string& userId) const;
+
+    size_t userCount() const;
+
+private:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kBuckets = 8;   // Days (or weeks) kept per ring
+
+    struct Bucket {
+        int64_t period = -1;    // Day or week number the counts belong to
+        PeriodStats counts;
+    };
+
+    struct UserStats {
+        explicit UserStats(size_t capacity) : contacts(capacity) {}
+        size_t sent = 0;
+        size_t received = 0;
+        std::array<Bucket, kBuckets> days;
+        std::array<Bucket, kBuckets> weeks;
+        SpaceSaving contacts;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, UserStats> users;
+    };
+
+    size_t topContactsCapacity_;
+    std::array<Shard, kShards> shards_;
+
+    Shard& shardFor(const std::string& userId);
+    const Shard& shardFor(const std::string& userId) const;
+    void recordOne(const std::string& userId, const std::string& contactId, bool sent, int64_t day);
+    static int64_t dayOf(std::chrono::system_clock::time_point tp);
+    static int64_t weekOf(int64_t day) { return (day + 3) / 7; }   // Weeks start on Monday (day 0 was a Thursday)
+    static void addTo(std::array<Bucket, kBuckets>& ring, int64_t period, bool sent);
+    static PeriodStats sumOf(const std::array<Bucket, kBuckets>& ring, int64_t from, int64_t to);
+};
+
+#endif // USERSTATSTRACKER_H
@@ -23,6 +23,15 @@ bool ChatMessage::isReply() const {
     return replyToMessageId > 0;
 }
 
+bool ChatMessage::isForwarded() const {
+    return forwardedFromMessageId > 0;
+}
+
+std::string ChatMessage::getForwardHeader() const {
+    if (!isForwarded()) return "";
+    return "[Forwarded from " + forwardedFromRoomName + "]";
+}
+
 bool ChatMessage::isReadBy(int userId) const {
     return readBy.count(userId) > 0;
 }
@@ -43,6 +52,8 @@ ChatMessage ChatMessage::fromDatabaseMessage(const ::Message& dbMessage) {
     }
 
     msg.content = dbMessage.content;
+    msg.forwardedFromMessageId = dbMessage.forwardedFrom;
+    msg.forwardedFromRoomName = dbMessage.forwardOrigin;
 
     // تبدیل timestamp از string به time_t
     if (!dbMessage.timestamp.empty()) {
@@ -70,7 +81,7 @@ ChatRoom::ChatRoom(int id, const std::string& name, const std::string& bio,
                    std::shared_ptr<Database> db)
     : id(id), name(name), bio(bio), profileImagePath(profileImagePath),
       isPrivate(isPrivate), creatorId(creatorId),
-      onlyAdminsCanMessage(false), nextMessageId(1), database(db)
+      onlyAdminsCanMessage(false), isChannel(false), nextMessageId(1), database(db)
 {
     admins.insert(creatorId);
     members.insert(creatorId);
@@ -92,11 +103,21 @@ std::string ChatRoom::getInviteLink() const { return inviteLink; }
 int ChatRoom::getCreatorId() const { return creatorId; }
 
 std::vector<int> ChatRoom::getMembers() const {
-    return std::vector<int>(members.begin(), members.end());
+    if (!isChannel) {
+        return members.toVector();
+    }
+
+    // Admins and subscribers are disjoint and both sorted
+    std::vector<int> all;
+    std::vector<int> staff = members.toVector();
+    std::vector<int> subs = subscribers.toVector();
+    all.reserve(staff.size() + subs.size());
+    std::merge(staff.begin(), staff.end(), subs.begin(), subs.end(), std::back_inserter(all));
+    return all;
 }
 
 std::vector<int> ChatRoom::getAdmins() const {
-    return std::vector<int>(admins.begin(), admins.end());
+    return admins.toVector();
 }
 
 std::vector<ChatMessage> ChatRoom::getMessages() const {
@@ -108,18 +129,27 @@ std::vector<int> ChatRoom::getPinnedMessages() const {
 }
 
 const ChatMessage* ChatRoom::getMessageById(int messageId) const {
-    for (const auto& msg : messages) {
-        if (msg.id == messageId) {
-            return &msg;
-        }
-    }
-    return nullptr;
+    auto it = messagePositions.find(messageId);
+    return it != messagePositions.end() ? &messages[it->second] : nullptr;
 }
 
 bool ChatRoom::getOnlyAdminsCanMessage() const {
     return onlyAdminsCanMessage;
 }
 
+bool ChatRoom::getIsChannel() const {
+    return isChannel;
+}
+
+size_t ChatRoom::getSubscriberCount() const {
+    return subscribers.cardinality();
+}
+
+// ================== Admission Control ==================
+void ChatRoom::setRateLimiter(std::shared_ptr<RateLimiter> limiter) {
+    rateLimiter = limiter;
+}
+
 // ================== Database Integration Methods ==================
 bool ChatRoom::syncWithDatabase() {
     return loadMessagesFromDatabase();
@@ -132,8 +162,16 @@ bool ChatRoom::loadMessagesFromDatabase() {
     auto dbMessages = database->getChatroomMessages(roomName);
 
     messages.clear();
+    searchIndex.clear();
+    messagePositions.clear();
+    replyIndex.clear();
+    // Both map to message IDs of the previous load; loaded rows use their row ID instead
+    storedRows.clear();
+    recentClientKeys = std::make_unique<DedupWindow>();
     for (const auto& dbMsg : dbMessages) {
         messages.push_back(ChatMessage::fromDatabaseMessage(dbMsg));
+        indexMessage(messages.back());
+        searchIndex.addMessage(dbMsg.id, dbMsg.content);
 
         if (dbMsg.id >= nextMessageId) {
             nextMessageId = dbMsg.id + 1;
@@ -149,18 +187,24 @@ bool ChatRoom::saveMessageToDatabase(const ChatMessage& message) {
     std::string senderUsername = std::to_string(message.senderId);
     std::string roomName = std::to_string(id);
 
+    if (message.isForwarded()) {
+        return database->forwardMessage(senderUsername, roomName, message.content,
+                                        message.forwardedFromMessageId, message.forwardedFromRoomName);
+    }
     return database->sendMessage(senderUsername, roomName, message.content);
 }
 
+int ChatRoom::saveMessageOnce(const ChatMessage& message, const std::string& clientKey) {
+    if (!database) return -1;
+    return database->storeMessageOnce(clientKey, std::to_string(message.senderId), std::to_string(id), message.content);
+}
+
 bool ChatRoom::saveRoomToDatabase() {
     if (!database) return false;
 
     std::string roomName = std::to_string(id);
     if (database->createChatroom(name)) {
-        for (int memberId : members) {
-            std::string username = std::to_string(memberId);
-            database->addUserToChatroom(username, name);
-        }
+        addMembersToDatabase(getMembers());
         return true;
     }
     return false;
@@ -173,6 +217,17 @@ bool ChatRoom::addMemberToDatabase(int userId) {
     return database->addUserToChatroom(username, name);
 }
 
+std::vector<bool> ChatRoom::addMembersToDatabase(const std::vector<int>& userIds) {
+    if (!database) return std::vector<bool>(userIds.size(), false);
+
+    std::vector<std::string> usernames;
+    usernames.reserve(userIds.size());
+    for (int userId : userIds) {
+        usernames.push_back(std::to_string(userId));
+    }
+    return database->addUsersToChatroom(usernames, name);
+}
+
 bool ChatRoom::removeMemberFromDatabase(int userId) {
     // این تابع نیاز به پیاده‌سازی در دیتابیس دارد
     return true;
@@ -241,9 +296,21 @@ OperationResult ChatRoom::setPrivacy(bool newPrivacy, int requesterId) {
 
 // ================== Member Management ==================
 OperationResult ChatRoom::addMember(int userId) {
-    if (members.count(userId)) {
+    if (isMember(userId)) {
         return {false, ChatRoomError::USER_ALREADY_MEMBER, "User is already a member"};
     }
+
+    if (isChannel) {
+        if (!subscribers.add(userId)) {
+            return {false, ChatRoomError::INVALID_REQUEST, "Invalid subscriber id"};
+        }
+        if (!addMemberToDatabase(userId)) {
+            subscribers.remove(userId);
+            return {false, ChatRoomError::INVALID_REQUEST, "Failed to add member to database"};
+        }
+        return {true};
+    }
+
     members.insert(userId);
 
     if (!addMemberToDatabase(userId)) {
@@ -254,6 +321,53 @@ OperationResult ChatRoom::addMember(int userId) {
     return {true};
 }
 
+OperationResult ChatRoom::addMembers(const std::vector<int>& userIds, std::vector<OperationResult>& results) {
+    results.assign(userIds.size(), OperationResult());
+
+    // Validate and apply to the in-memory membership in one pass
+    std::vector<int> pending;
+    std::vector<size_t> pendingIndex;
+    std::set<int> seen;
+    for (size_t i = 0; i < userIds.size(); i++) {
+        int userId = userIds[i];
+        if (isMember(userId) || !seen.insert(userId).second) {
+            results[i] = {false, ChatRoomError::USER_ALREADY_MEMBER, "User is already a member"};
+            continue;
+        }
+        bool added = isChannel ? subscribers.add(userId) : members.insert(userId);
+        if (!added) {
+            results[i] = {false, ChatRoomError::INVALID_REQUEST, "Invalid member id"};
+            continue;
+        }
+        pending.push_back(userId);
+        pendingIndex.push_back(i);
+    }
+
+    if (pending.empty()) {
+        return {true};
+    }
+
+    std::vector<bool> saved = addMembersToDatabase(pending);
+    size_t savedCount = 0;
+    for (size_t j = 0; j < pending.size(); j++) {
+        if (saved[j]) {
+            savedCount++;
+            continue;
+        }
+        if (isChannel) {
+            subscribers.remove(pending[j]);
+        } else {
+            members.erase(pending[j]);
+        }
+        results[pendingIndex[j]] = {false, ChatRoomError::INVALID_REQUEST, "Failed to add member to database"};
+    }
+
+    if (savedCount == 0) {
+        return {false, ChatRoomError::INVALID_REQUEST, "Failed to add members to database"};
+    }
+    return {true};
+}
+
 OperationResult ChatRoom::addMember(int requesterId, int userId) {
     if (!hasAdminPrivilege(requesterId)) {
         return {false, ChatRoomError::PERMISSION_DENIED, "Only admins can add members"};
@@ -265,13 +379,22 @@ OperationResult ChatRoom::addMember(int requesterId, int userId) {
 }
 
 OperationResult ChatRoom::removeMember(int userId) {
-    if (!members.count(userId)) {
+    if (!isMember(userId)) {
         return {false, ChatRoomError::USER_NOT_MEMBER, "User is not a member"};
     }
     if (userId == creatorId) {
         return {false, ChatRoomError::CANNOT_REMOVE_OWNER, "Cannot remove group owner"};
     }
 
+    if (isChannel && subscribers.remove(userId)) {
+        readWatermarks.erase(userId);
+        if (!removeMemberFromDatabase(userId)) {
+            subscribers.add(userId);
+            return {false, ChatRoomError::INVALID_REQUEST, "Failed to remove member from database"};
+        }
+        return {true};
+    }
+
     members.erase(userId);
     admins.erase(userId);
 
@@ -297,7 +420,30 @@ OperationResult ChatRoom::removeMember(int requesterId, int userId) {
 }
 
 bool ChatRoom::isMember(int userId) const {
-    return members.count(userId) > 0;
+    return members.count(userId) > 0 || (isChannel && subscribers.contains(userId));
+}
+
+OperationResult ChatRoom::convertToChannel(int requesterId) {
+    if (!isOwner(requesterId)) {
+        return {false, ChatRoomError::NOT_OWNER, "Only owner can convert group to channel"};
+    }
+    if (isChannel) {
+        return {true};
+    }
+
+    // Non-admin members become subscribers; their read state restarts at the latest message
+    int lastMessageId = messages.empty() ? 0 : messages.back().id;
+    for (int userId : members.toVector()) {
+        if (!hasAdminPrivilege(userId)) {
+            subscribers.add(userId);
+            readWatermarks[userId] = lastMessageId;
+            members.erase(userId);
+        }
+    }
+
+    isChannel = true;
+    onlyAdminsCanMessage = true;
+    return {true};
 }
 
 bool ChatRoom::isOwner(int userId) const {
@@ -312,6 +458,9 @@ OperationResult ChatRoom::addAdmin(int userId, int requesterId) {
     if (!isMember(userId)) {
         return {false, ChatRoomError::USER_NOT_MEMBER, "User is not a member"};
     }
+    if (isChannel && subscribers.remove(userId)) {
+        members.insert(userId);
+    }
     admins.insert(userId);
     return {true};
 }
@@ -327,6 +476,10 @@ OperationResult ChatRoom::removeAdmin(int userId, int requesterId) {
         return {false, ChatRoomError::NOT_ADMIN, "User is not an admin"};
     }
     admins.erase(userId);
+    if (isChannel) {
+        members.erase(userId);
+        subscribers.add(userId);
+    }
     return {true};
 }
 
@@ -358,21 +511,14 @@ OperationResult ChatRoom::sendMessage(int senderId, const std::string& content)
         return {false, ChatRoomError::MESSAGE_TOO_LONG, "Message too long (max 1000 characters)"};
     }
 
-    ChatMessage msg(nextMessageId++, senderId, content);
-    messages.push_back(msg);
-
-    if (!saveMessageToDatabase(msg)) {
-        messages.pop_back();
-        nextMessageId--;
-        return {false, ChatRoomError::INVALID_REQUEST, "Failed to save message to database"};
-    }
-
-    return {true};
+    ChatMessage msg(nextMessageId, senderId, content);
+    return storeNewMessage(msg);
 }
 
 OperationResult ChatRoom::sendMessage(int senderId, const std::string& content,
                                      const std::string& attachmentPath,
-                                     int replyToMessageId)
+                                     int replyToMessageId,
+                                     const std::string& clientKey)
 {
     if (!isMember(senderId)) {
         return {false, ChatRoomError::NOT_MEMBER, "User is not a member"};
@@ -390,16 +536,79 @@ OperationResult ChatRoom::sendMessage(int senderId, const std::string& content,
         return {false, ChatRoomError::REPLY_MESSAGE_NOT_FOUND, "Reply message not found"};
     }
 
-    ChatMessage msg(nextMessageId++, senderId, content, attachmentPath, replyToMessageId);
+    ChatMessage msg(nextMessageId, senderId, content, attachmentPath, replyToMessageId);
+    return storeNewMessage(msg, clientKey);
+}
+
+OperationResult ChatRoom::storeNewMessage(const ChatMessage& msg, const std::string& clientKey) {
+    // A retry is answered from memory, before it can use up the sender's rate limit
+    std::string dedupKey;
+    if (!clientKey.empty()) {
+        dedupKey = std::to_string(msg.senderId) + '\x1f' + clientKey;
+        if (std::optional<int> known = recentClientKeys->find(dedupKey)) {
+            OperationResult result(true);
+            result.messageId = *known;
+            return result;
+        }
+    }
+
+    // Admission control runs before any database work
+    if (rateLimiter) {
+        AdmissionDecision decision = rateLimiter->tryAcquire(std::to_string(msg.senderId), std::to_string(id));
+        if (!decision.allowed) {
+            OperationResult result(false, ChatRoomError::RATE_LIMITED, "Too many messages, try again later");
+            result.retryAfterMs = decision.retryAfter.count();
+            return result;
+        }
+    }
+
+    nextMessageId++;
     messages.push_back(msg);
+    indexMessage(msg);
+
+    int storedId = -1;
+    bool saved = clientKey.empty() ? saveMessageToDatabase(msg) : (storedId = saveMessageOnce(msg, clientKey)) > 0;
+
+    // The key outlived the window: the database returned the row of an earlier send. A message
+    // sent since the last load is found through storedRows; one loaded from the database kept
+    // its row ID as message ID. A row this room does not hold is kept as the new message
+    const ChatMessage* original = nullptr;
+    if (storedId > 0) {
+        auto row = storedRows.find(storedId);
+        if (row != storedRows.end()) {
+            original = getMessageById(row->second);
+        } else if (storedId != msg.id) {
+            original = getMessageById(storedId);
+            if (original && (original->senderId != msg.senderId || original->content != msg.content.str())) {
+                original = nullptr;
+            }
+        }
+        if (!original) {
+            storedRows[storedId] = msg.id;
+        }
+    }
 
-    if (!saveMessageToDatabase(msg)) {
+    if (!saved || original) {
+        unindexMessage(msg);
         messages.pop_back();
         nextMessageId--;
-        return {false, ChatRoomError::INVALID_REQUEST, "Failed to save message to database"};
+        if (!saved) {
+            return {false, ChatRoomError::INVALID_REQUEST, "Failed to save message to database"};
+        }
     }
 
-    return {true};
+    OperationResult result(true);
+    result.messageId = original ? original->id : msg.id;
+    if (!dedupKey.empty()) {
+        recentClientKeys->remember(dedupKey, result.messageId);
+    }
+    if (!original) {
+        searchIndex.addMessage(msg.id, msg.content);
+        if (isChannel) {
+            readWatermarks[msg.senderId] = msg.id;
+        }
+    }
+    return result;
 }
 
 OperationResult ChatRoom::editMessage(int messageId, int senderId, const std::string& newContent) {
@@ -432,24 +641,28 @@ OperationResult ChatRoom::editMessage(int messageId, int senderId, const std::st
         return {false, ChatRoomError::INVALID_REQUEST, "Failed to update message in database"};
     }
 
+    searchIndex.updateMessage(messageId, oldContent, newContent);
     return {true};
 }
 
 OperationResult ChatRoom::deleteMessage(int messageId, int requesterId) {
-    for (auto it = messages.begin(); it != messages.end(); ++it) {
-        if (it->id == messageId) {
-            if (it->senderId == requesterId || hasAdminPrivilege(requesterId)) {
-                ChatMessage deletedMsg = *it;
-                messages.erase(it);
-
-                // حذف از دیتابیس (نیاز به پیاده‌ستی تابع deleteMessage در دیتابیس)
-                return {true};
-            } else {
-                return {false, ChatRoomError::PERMISSION_DENIED, "Only sender or admin can delete message"};
-            }
-        }
+    auto pos = messagePositions.find(messageId);
+    if (pos == messagePositions.end()) {
+        return {false, ChatRoomError::MESSAGE_NOT_FOUND, "Message not found"};
+    }
+    size_t index = pos->second;
+    if (messages[index].senderId != requesterId && !hasAdminPrivilege(requesterId)) {
+        return {false, ChatRoomError::PERMISSION_DENIED, "Only sender or admin can delete message"};
     }
-    return {false, ChatRoomError::MESSAGE_NOT_FOUND, "Message not found"};
+
+    ChatMessage deletedMsg = messages[index];
+    messages.erase(messages.begin() + static_cast<std::ptrdiff_t>(index));
+    unindexMessage(deletedMsg);
+    shiftMessagePositions(index);
+    searchIndex.removeMessage(deletedMsg.id, deletedMsg.content);
+
+    // حذف از دیتابیس (نیاز به پیاده‌ستی تابع deleteMessage در دیتابیس)
+    return {true};
 }
 
 OperationResult ChatRoom::markMessageAsRead(int messageId, int userId) {
@@ -462,6 +675,15 @@ OperationResult ChatRoom::markMessageAsRead(int messageId, int userId) {
         return {false, ChatRoomError::MESSAGE_NOT_FOUND, "Message not found"};
     }
 
+    if (isChannel) {
+        // Channels never touch per-message state: one watermark per reader
+        int& watermark = readWatermarks[userId];
+        if (messageId > watermark) {
+            watermark = messageId;
+        }
+        return {true};
+    }
+
     msg->readBy.insert(userId);
 
     // به‌روزرسانی در دیتابیس
@@ -487,14 +709,44 @@ OperationResult ChatRoom::forwardMessage(int messageId, int forwarderId, ChatRoo
         return {false, ChatRoomError::FORWARD_MESSAGE_NOT_FOUND, "Message not found for forwarding"};
     }
 
-    std::string forwardContent = "[Forwarded from " + getName() + "] " + msg->content;
-    return targetRoom.sendMessage(forwarderId, forwardContent);
+    return targetRoom.receiveForward(*msg, forwarderId, *this);
+}
+
+OperationResult ChatRoom::receiveForward(const ChatMessage& original, int forwarderId, const ChatRoom& sourceRoom) {
+    if (onlyAdminsCanMessage && !isAdmin(forwarderId)) {
+        return {false, ChatRoomError::FORWARD_PERMISSION_DENIED, "Only admins can send messages"};
+    }
+
+    // Share the original body; only the forward-origin header is new.
+    // A forward of a forward keeps pointing at the first origin.
+    ChatMessage forwarded(nextMessageId, forwarderId, "", original.attachmentPath);
+    forwarded.content = original.content;
+    if (original.isForwarded()) {
+        forwarded.forwardedFromMessageId = original.forwardedFromMessageId;
+        forwarded.forwardedFromRoomId = original.forwardedFromRoomId;
+        forwarded.forwardedFromRoomName = original.forwardedFromRoomName;
+    } else {
+        forwarded.forwardedFromMessageId = original.id;
+        forwarded.forwardedFromRoomId = sourceRoom.getId();
+        forwarded.forwardedFromRoomName = sourceRoom.getName();
+    }
+
+    return storeNewMessage(forwarded);
 }
 
 // ================== Statistics and Analytics ==================
 int ChatRoom::getUnreadCount(int userId) const {
     if (!isMember(userId)) return 0;
 
+    if (isChannel) {
+        // Message ids are ascending, so everything after the watermark is unread
+        auto it = readWatermarks.find(userId);
+        int watermark = it != readWatermarks.end() ? it->second : 0;
+        auto first = std::upper_bound(messages.begin(), messages.end(), watermark,
+                                      [](int id, const ChatMessage& msg) { return id < msg.id; });
+        return messages.end() - first;
+    }
+
     int count = 0;
     for (const auto& msg : messages) {
         if (!msg.isReadBy(userId)) {
@@ -509,25 +761,59 @@ int ChatRoom::getTotalMessages() const {
 }
 
 int ChatRoom::getActiveMembersCount() const {
-    return members.size();
+    return members.size() + subscribers.cardinality();
 }
 
 std::vector<ChatMessage> ChatRoom::getMessagesWithReplies() const {
-    std::vector<ChatMessage> messagesWithReplies;
-    for (const auto& msg : messages) {
-        if (msg.isReply()) {
-            messagesWithReplies.push_back(msg);
+    std::vector<size_t> positions;
+    for (const auto& [parentId, replies] : replyIndex) {
+        for (int replyId : replies) {
+            positions.push_back(messagePositions.at(replyId));
         }
     }
+    std::sort(positions.begin(), positions.end());
+
+    std::vector<ChatMessage> messagesWithReplies;
+    messagesWithReplies.reserve(positions.size());
+    for (size_t pos : positions) {
+        messagesWithReplies.push_back(messages[pos]);
+    }
     return messagesWithReplies;
 }
 
+std::vector<ChatMessage> ChatRoom::getReplies(int messageId, size_t offset, size_t limit) const {
+    std::vector<ChatMessage> replies;
+    auto it = replyIndex.find(messageId);
+    if (it == replyIndex.end() || offset >= it->second.size()) {
+        return replies;
+    }
+
+    size_t end = std::min(it->second.size(), offset + std::min(limit, it->second.size()));
+    for (size_t i = offset; i < end; i++) {
+        replies.push_back(*getMessageById(it->second[i]));
+    }
+    return replies;
+}
+
+int ChatRoom::getReplyCount(int messageId) const {
+    auto it = replyIndex.find(messageId);
+    return it != replyIndex.end() ? it->second.size() : 0;
+}
+
 std::vector<ChatMessage> ChatRoom::getUnreadMessages(int userId) const {
     std::vector<ChatMessage> unreadMessages;
     if (!isMember(userId)) {
         return unreadMessages;
     }
 
+    if (isChannel) {
+        auto it = readWatermarks.find(userId);
+        int watermark = it != readWatermarks.end() ? it->second : 0;
+        auto first = std::upper_bound(messages.begin(), messages.end(), watermark,
+                                      [](int id, const ChatMessage& msg) { return id < msg.id; });
+        return std::vector<ChatMessage>(first, messages.end());
+    }
+
     for (const auto& msg : messages) {
         if (!msg.isReadBy(userId)) {
             unreadMessages.push_back(msg);
@@ -566,11 +852,41 @@ OperationResult ChatRoom::pinMessage(int userId, int messageId) {
 
 OperationResult ChatRoom::searchMessages(const std::string& keyword, std::vector<ChatMessage>& results) const {
     results.clear();
-    for (const auto& msg : messages) {
-        if (msg.content.find(keyword) != std::string::npos) {
-            results.push_back(msg);
+
+    std::vector<int> hits;
+    if (!searchIndex.search(keyword, hits)) {
+        // کلیدواژه‌ی بدون توکن (مثلاً فقط علائم): جستجوی خطی مثل قبل
+        for (const auto& msg : messages) {
+            if (msg.content.find(keyword) != std::string::npos) {
+                results.push_back(msg);
+            }
+        }
+        return {true};
+    }
+
+    // Only the hits are touched; sorting their positions keeps the room's message order
+    std::vector<size_t> positions;
+    positions.reserve(hits.size());
+    for (int hitId : hits) {
+        auto it = messagePositions.find(hitId);
+        if (it != messagePositions.end()) {
+            positions.push_back(it->second);
         }
     }
+    std::sort(positions.begin(), positions.end());
+
+    results.reserve(positions.size());
+    for (size_t pos : positions) {
+        results.push_back(messages[pos]);
+    }
+    return {true};
+}
+
+OperationResult ChatRoom::searchMessageIds(const std::string& keyword, std::vector<int>& messageIds,
+                                           size_t offset, size_t limit) const {
+    if (!searchIndex.search(keyword, messageIds, offset, limit)) {
+        return {false, ChatRoomError::INVALID_REQUEST, "Search query has no searchable words"};
+    }
     return {true};
 }
 
@@ -595,17 +911,42 @@ bool ChatRoom::hasAdminPrivilege(int userId) const {
 }
 
 ChatMessage* ChatRoom::findMessageById(int messageId) {
-    for (auto& msg : messages) {
-        if (msg.id == messageId) {
-            return &msg;
+    auto it = messagePositions.find(messageId);
+    return it != messagePositions.end() ? &messages[it->second] : nullptr;
+}
+
+void ChatRoom::indexMessage(const ChatMessage& message) {
+    messagePositions[message.id] = messages.size() - 1;
+    if (message.isReply()) {
+        auto& replies = replyIndex[message.replyToMessageId];
+        replies.insert(std::upper_bound(replies.begin(), replies.end(), message.id), message.id);
+    }
+}
+
+void ChatRoom::unindexMessage(const ChatMessage& message) {
+    messagePositions.erase(message.id);
+    if (message.isReply()) {
+        auto it = replyIndex.find(message.replyToMessageId);
+        if (it != replyIndex.end()) {
+            auto& replies = it->second;
+            replies.erase(std::remove(replies.begin(), replies.end(), message.id), replies.end());
+            if (replies.empty()) {
+                replyIndex.erase(it);
+            }
         }
     }
-    return nullptr;
+}
+
+void ChatRoom::shiftMessagePositions(size_t from) {
+    // Only messages behind an erased one moved, each by exactly one slot
+    for (size_t i = from; i < messages.size(); i++) {
+        messagePositions[messages[i].id]--;
+    }
 }
 
 // ================== ChatRoomManager Class Implementation ==================
 ChatRoomManager::ChatRoomManager(std::shared_ptr<Database> db)
-    : nextRoomId(1), database(db)
+    : nextRoomId(1), database(db), rateLimiter(std::make_shared<RateLimiter>())
 {
     loadAllRoomsFromDatabase();
 }
@@ -656,6 +997,7 @@ OperationResult ChatRoomManager::createRoom(const std::string& name, const std::
     ChatRoom room(nextRoomId, name, bio, profileImagePath, isPrivate, creatorId, database);
     auto result = chatRooms.emplace(nextRoomId, std::move(room));
     outRoom = &result.first->second;
+    outRoom->setRateLimiter(rateLimiter);
 
     if (!outRoom->saveRoomToDatabase()) {
         chatRooms.erase(nextRoomId);
@@ -666,6 +1008,16 @@ OperationResult ChatRoomManager::createRoom(const std::string& name, const std::
     return {true};
 }
 
+OperationResult ChatRoomManager::createChannel(const std::string& name, const std::string& bio,
+                                              const std::string& profileImagePath,
+                                              int creatorId, ChatRoom*& outRoom) {
+    OperationResult result = createRoom(name, bio, profileImagePath, false, creatorId, outRoom);
+    if (!result.success) {
+        return result;
+    }
+    return outRoom->convertToChannel(creatorId);
+}
+
 OperationResult ChatRoomManager::deleteRoom(int roomId, int requesterId) {
     auto it = chatRooms.find(roomId);
     if (it == chatRooms.end()) {
@@ -712,6 +1064,22 @@ OperationResult ChatRoomManager::addMemberToRoom(int roomId, int userId, int req
     return room->addMember(userId);
 }
 
+OperationResult ChatRoomManager::addMembersToRoom(int roomId, const std::vector<int>& userIds,
+                                                 std::vector<OperationResult>& results, int requesterId) {
+    auto* room = getRoomById(roomId);
+    if (!room) {
+        results.assign(userIds.size(), {false, ChatRoomError::ROOM_NOT_FOUND, "Room not found"});
+        return {false, ChatRoomError::ROOM_NOT_FOUND, "Room not found"};
+    }
+
+    if (room->getIsPrivate() && requesterId >= 0 && !room->isAdmin(requesterId)) {
+        results.assign(userIds.size(), {false, ChatRoomError::PERMISSION_DENIED, "Only admins can add members to private groups"});
+        return {false, ChatRoomError::PERMISSION_DENIED, "Only admins can add members to private groups"};
+    }
+
+    return room->addMembers(userIds, results);
+}
+
 OperationResult ChatRoomManager::addMemberByLink(const std::string& inviteLink, int userId) {
     auto* room = getRoomByLink(inviteLink);
     if (!room) {
@@ -737,6 +1105,15 @@ OperationResult ChatRoomManager::removeMemberFromRoom(int roomId, int userId, in
     return room->removeMember(userId);
 }
 
+// ================== Admission Control ==================
+void ChatRoomManager::setRateLimits(const RateLimiterConfig& config) {
+    rateLimiter->setConfig(config);
+}
+
+RateLimiterStats ChatRoomManager::getRateLimiterStats() const {
+    return rateLimiter->getStats();
+}
+
 // ================== Statistics ==================
 std::vector<int> ChatRoomManager::getAllRoomIds() const {
     std::vector<int> ids;
@@ -7,7 +7,13 @@
 #include <map>
 #include <ctime>
 #include <memory>
+#include <unordered_map>
 #include "Database.h"
+#include "MessageSearchIndex.h"
+#include "SubscriberBitmap.h"
+#include "MemberSet.h"
+#include "RateLimiter.h"
+#include "DedupWindow.h"
 
 enum class ChatRoomError {
     SUCCESS,                    // Operation completed successfully
@@ -31,13 +37,16 @@ enum class ChatRoomError {
     MESSAGE_ALREADY_PINNED,     // Message is already pinned
     ATTACHMENT_TOO_LARGE,       // Attachment exceeds size limit
     INVALID_ATTACHMENT_TYPE,    // Attachment type not allowed
-    REPLY_MESSAGE_NOT_FOUND     // Message being replied to not found
+    REPLY_MESSAGE_NOT_FOUND,    // Message being replied to not found
+    RATE_LIMITED                // Too many requests; retry after retryAfterMs
 };
 
 struct OperationResult {
     bool success;               // True if operation succeeded
     ChatRoomError error;        // Error code if operation failed
     std::string message;        // Human-readable error/success message
+    long long retryAfterMs = 0; // For RATE_LIMITED: how long to wait before retrying
+    int messageId = -1;         // For sends: id of the stored message (the first one for a repeated client key)
 
     OperationResult(bool success = true,
                    ChatRoomError error = ChatRoomError::SUCCESS,
@@ -45,15 +54,46 @@ struct OperationResult {
         : success(success), error(error), message(message) {}
 };
 
+// Immutable, reference-counted message text. Copies share one buffer, so a
+// forwarded message costs a pointer instead of a second copy of the text.
+class MessageContent {
+public:
+    MessageContent() : text(std::make_shared<const std::string>()) {}
+    MessageContent(const std::string& value) : text(std::make_shared<const std::string>(value)) {}
+    MessageContent(std::string&& value) : text(std::make_shared<const std::string>(std::move(value))) {}
+    MessageContent(const char* value) : text(std::make_shared<const std::string>(value)) {}
+
+    operator const std::string&() const { return *text; }
+    const std::string& str() const { return *text; }
+    size_t length() const { return text->length(); }
+    size_t size() const { return text->size(); }
+    bool empty() const { return text->empty(); }
+    size_t find(const std::string& needle, size_t pos = 0) const { return text->find(needle, pos); }
+    bool sharesBufferWith(const MessageContent& other) const { return text == other.text; }
+
+    friend bool operator==(const MessageContent& a, const std::string& b) { return *a.text == b; }
+    friend bool operator==(const std::string& a, const MessageContent& b) { return a == *b.text; }
+    friend bool operator!=(const MessageContent& a, const std::string& b) { return *a.text != b; }
+    friend std::string operator+(const std::string& a, const MessageContent& b) { return a + *b.text; }
+
+private:
+    std::shared_ptr<const std::string> text;
+};
+
 struct ChatMessage {
     int id;                     // Unique message identifier
     int senderId;               // ID of user who sent the message
-    std::string content;        // Text content of the message
+    MessageContent content;     // Text content of the message (shared with forwards)
     std::string attachmentPath; // Path to attached file (optional)
     int replyToMessageId;       // ID of message being replied to (optional)
     std::time_t timestamp;      // Unix timestamp of message creation
     std::set<int> readBy;       // Set of user IDs who have read the message
 
+    // ============ Forward Origin ============
+    int forwardedFromMessageId = -1;    // Original message ID (-1 if not forwarded)
+    int forwardedFromRoomId = -1;       // Room the original was posted in
+    std::string forwardedFromRoomName;  // Room name at forward time
+
     ChatMessage() : id(-1), senderId(-1), replyToMessageId(-1), timestamp(0) {}
 
     ChatMessage(int id, int senderId, const std::string& content,
@@ -65,6 +105,8 @@ struct ChatMessage {
     int getReadCount() const;
     bool hasAttachment() const;
     bool isReply() const;
+    bool isForwarded() const;
+    std::string getForwardHeader() const; // e.g. "[Forwarded from General]", empty if not forwarded
 
     // تابع تبدیل برای دیتابیس
     static ChatMessage fromDatabaseMessage(const ::Message& dbMessage);
@@ -82,17 +124,30 @@ private:
     int creatorId;              // ID of user who created the room
 
     // ============ Member Management ============
-    std::set<int> members;      // Set of member user IDs
-    std::set<int> admins;       // Set of admin user IDs
+    MemberSet members;          // Set of member user IDs
+    MemberSet admins;           // Set of admin user IDs
     bool onlyAdminsCanMessage;  // Restriction setting for messaging
 
+    // ============ Channel Mode ============
+    // In a channel, `members` only holds the owner and admins; everyone else is a
+    // subscriber in the bitmap and tracks reads with a single watermark.
+    bool isChannel;                         // Broadcast channel (fan-out-on-read)
+    SubscriberBitmap subscribers;           // Non-admin channel members
+    std::unordered_map<int, int> readWatermarks; // User ID -> last read message ID
+
     // ============ Message Management ============
     std::vector<ChatMessage> messages;      // List of all messages
     std::vector<int> pinnedMessages;    // List of pinned message IDs
     int nextMessageId;          // Next available message ID
+    MessageSearchIndex searchIndex; // Token index over message contents
+    std::unordered_map<int, size_t> messagePositions; // Message ID -> index in messages
+    std::map<int, std::vector<int>> replyIndex;       // Parent message ID -> reply IDs (ascending)
 
     // اضافه شده: اشاره‌گر به دیتابیس
     std::shared_ptr<Database> database;
+    std::shared_ptr<RateLimiter> rateLimiter;   // Shared admission control (optional)
+    std::unique_ptr<DedupWindow> recentClientKeys = std::make_unique<DedupWindow>(); // Sender + client key -> message ID
+    std::unordered_map<int, int> storedRows;  // Database row ID -> message ID, for messages sent with a client key
 
 public:
     ChatRoom(int id, const std::string& name, const std::string& bio,
@@ -112,6 +167,8 @@ public:
     std::vector<ChatMessage> getMessages() const;
     std::vector<int> getPinnedMessages() const;
     bool getOnlyAdminsCanMessage() const;
+    bool getIsChannel() const;
+    size_t getSubscriberCount() const;
     const ChatMessage* getMessageById(int messageId) const;
 
     // ================= Group Information Management =================
@@ -124,10 +181,12 @@ public:
     // ================= Member Management =================
     OperationResult addMember(int userId);
     OperationResult addMember(int requesterId, int userId);
+    OperationResult addMembers(const std::vector<int>& userIds, std::vector<OperationResult>& results);
     OperationResult removeMember(int userId);
     OperationResult removeMember(int requesterId, int userId);
     bool isMember(int userId) const;
     bool isOwner(int userId) const;
+    OperationResult convertToChannel(int requesterId);
 
     // ================= Admin Management =================
     OperationResult addAdmin(int userId, int requesterId);
@@ -137,29 +196,40 @@ public:
     // ================= Message Management =================
     OperationResult setOnlyAdminsCanMessage(bool value, int requesterId);
     OperationResult sendMessage(int senderId, const std::string& content);
+    // A non-empty clientKey makes the send safe to retry: a repeat stores nothing and
+    // reports the first message's ID in OperationResult::messageId
     OperationResult sendMessage(int senderId, const std::string& content,
                                const std::string& attachmentPath,
-                               int replyToMessageId);
+                               int replyToMessageId,
+                               const std::string& clientKey = "");
     OperationResult editMessage(int messageId, int senderId, const std::string& newContent);
     OperationResult deleteMessage(int messageId, int requesterId);
     OperationResult markMessageAsRead(int messageId, int userId);
     OperationResult forwardMessage(int messageId, int forwarderId, ChatRoom& targetRoom);
     OperationResult pinMessage(int userId, int messageId);
     OperationResult searchMessages(const std::string& keyword, std::vector<ChatMessage>& results) const; // تغییر نوع
+    OperationResult searchMessageIds(const std::string& keyword, std::vector<int>& messageIds,
+                                     size_t offset = 0, size_t limit = 50) const;
 
     // ================= Utilities and Statistics =================
     std::vector<ChatMessage> getMessagesWithReplies() const; // تغییر نوع
+    std::vector<ChatMessage> getReplies(int messageId, size_t offset = 0, size_t limit = 50) const;
+    int getReplyCount(int messageId) const;
     std::vector<ChatMessage> getUnreadMessages(int userId) const; // تغییر نوع
     int getUnreadCount(int userId) const;
     int getTotalMessages() const;
     int getActiveMembersCount() const;
 
+    // ================= Admission Control =================
+    void setRateLimiter(std::shared_ptr<RateLimiter> limiter);
+
     // ================= Database Integration =================
     bool syncWithDatabase();
     bool loadMessagesFromDatabase();
     bool saveMessageToDatabase(const ChatMessage& message); // تغییر نوع
     bool saveRoomToDatabase();
     bool addMemberToDatabase(int userId);
+    std::vector<bool> addMembersToDatabase(const std::vector<int>& userIds);
     bool removeMemberFromDatabase(int userId);
 
 private:
@@ -167,6 +237,12 @@ private:
     void generateInviteLink();
     bool hasAdminPrivilege(int userId) const;
     ChatMessage* findMessageById(int messageId); // تغییر نوع
+    OperationResult storeNewMessage(const ChatMessage& msg, const std::string& clientKey = ""); // Append, persist and index (rolls back on failure)
+    int saveMessageOnce(const ChatMessage& message, const std::string& clientKey); // Database row ID, -1 on failure
+    OperationResult receiveForward(const ChatMessage& original, int forwarderId, const ChatRoom& sourceRoom);
+    void indexMessage(const ChatMessage& message);   // Position + reply index for a newly appended message
+    void unindexMessage(const ChatMessage& message);
+    void shiftMessagePositions(size_t from); // Moves positions at or after from back by one after an erase
 
     // توابع کمکی برای تبدیل
     std::string userIdToUsername(int userId) const;
@@ -180,6 +256,7 @@ private:
 
     // اضافه شده: اشاره‌گر به دیتابیس
     std::shared_ptr<Database> database;
+    std::shared_ptr<RateLimiter> rateLimiter;   // Shared by every room
 
 public:
     ChatRoomManager(std::shared_ptr<Database> db);
@@ -188,6 +265,9 @@ public:
     OperationResult createRoom(const std::string& name, const std::string& bio,
                               const std::string& profileImagePath, bool isPrivate,
                               int creatorId, ChatRoom*& outRoom);
+    OperationResult createChannel(const std::string& name, const std::string& bio,
+                                  const std::string& profileImagePath,
+                                  int creatorId, ChatRoom*& outRoom);
     OperationResult deleteRoom(int roomId, int requesterId);
 
     // ================= Room Search =================
@@ -199,9 +279,15 @@ public:
 
     // ================= Member Management =================
     OperationResult addMemberToRoom(int roomId, int userId, int requesterId = -1);
+    OperationResult addMembersToRoom(int roomId, const std::vector<int>& userIds,
+                                     std::vector<OperationResult>& results, int requesterId = -1);
     OperationResult addMemberByLink(const std::string& inviteLink, int userId);
     OperationResult removeMemberFromRoom(int roomId, int userId, int requesterId = -1);
 
+    // ================= Admission Control =================
+    void setRateLimits(const RateLimiterConfig& config);
+    RateLimiterStats getRateLimiterStats() const;
+
     // ================= Statistics =================
     int getTotalRoomsCount() const;
     int getUserRoomCount(int userId) const;
@@ -0,0 +1,214 @@
+#include "CompactMessageStore.h"
+#include "ChatRoomManager.h"
+#include <algorithm>
+
+// ================== Mutation ==================
+uint32_t CompactMessageStore::storeContent(const std::string& content) {
+    uint32_t offset = static_cast<uint32_t>(arena.size());
+    arena.append(content);
+    return offset;
+}
+
+size_t CompactMessageStore::append(int id, int senderId, const std::string& content,
+                                   std::time_t timestamp, int replyToMessageId,
+                                   const std::string& attachmentPath) {
+    size_t pos = ids.size();
+    if (!ids.empty() && id <= ids.back()) {
+        idsAscending = false;
+    }
+
+    uint8_t flag = 0;
+    if (!attachmentPath.empty()) {
+        flag |= FLAG_ATTACHMENT;
+        attachments.emplace(pos, attachmentPath);
+    }
+    if (replyToMessageId > 0) {
+        flag |= FLAG_REPLY;
+    }
+
+    ids.push_back(id);
+    senderIds.push_back(senderId);
+    timestamps.push_back(timestamp);
+    replyTo.push_back(replyToMessageId);
+    contentOffsets.push_back(storeContent(content));
+    contentLengths.push_back(static_cast<uint32_t>(content.size()));
+    flags.push_back(flag);
+    live++;
+
+    // Like ChatMessage, the sender has implicitly read their own message
+    readPositions[senderId].push_back(static_cast<uint32_t>(pos));
+    return pos;
+}
+
+size_t CompactMessageStore::append(const ChatMessage& message) {
+    size_t pos = append(message.id, message.senderId, message.content, message.timestamp,
+                        message.replyToMessageId, message.attachmentPath);
+    for (int userId : message.readBy) {
+        markRead(pos, userId);
+    }
+    return pos;
+}
+
+bool CompactMessageStore::editContent(size_t pos, const std::string& newContent) {
+    if (pos >= ids.size() || isDeleted(pos)) return false;
+
+    deadArenaBytes += contentLengths[pos];
+    contentOffsets[pos] = storeContent(newContent);
+    contentLengths[pos] = static_cast<uint32_t>(newContent.size());
+    return true;
+}
+
+bool CompactMessageStore::remove(size_t pos) {
+    if (pos >= ids.size() || isDeleted(pos)) return false;
+
+    flags[pos] |= FLAG_DELETED;
+    deadArenaBytes += contentLengths[pos];
+    contentLengths[pos] = 0;
+    attachments.erase(pos);
+    live--;
+    return true;
+}
+
+void CompactMessageStore::markRead(size_t pos, int userId) {
+    if (pos >= ids.size()) return;
+
+    auto& positions = readPositions[userId];
+    uint32_t p = static_cast<uint32_t>(pos);
+    if (positions.empty() || positions.back() < p) {
+        positions.push_back(p);
+        return;
+    }
+    auto it = std::lower_bound(positions.begin(), positions.end(), p);
+    if (it == positions.end() || *it != p) {
+        positions.insert(it, p);
+    }
+}
+
+void CompactMessageStore::compact() {
+    if (deadArenaBytes == 0) return;
+
+    std::string packed;
+    packed.reserve(arena.size() - deadArenaBytes);
+    for (size_t pos = 0; pos < ids.size(); pos++) {
+        uint32_t offset = static_cast<uint32_t>(packed.size());
+        packed.append(arena, contentOffsets[pos], contentLengths[pos]);
+        contentOffsets[pos] = offset;
+    }
+    arena.swap(packed);
+    deadArenaBytes = 0;
+}
+
+void CompactMessageStore::clear() {
+    ids.clear();
+    senderIds.clear();
+    timestamps.clear();
+    replyTo.clear();
+    contentOffsets.clear();
+    contentLengths.clear();
+    flags.clear();
+    arena.clear();
+    attachments.clear();
+    readPositions.clear();
+    deadArenaBytes = 0;
+    live = 0;
+    idsAscending = true;
+}
+
+// ================== Lookup ==================
+size_t CompactMessageStore::findPosition(int id) const {
+    if (idsAscending) {
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        return (it != ids.end() && *it == id) ? static_cast<size_t>(it - ids.begin()) : npos;
+    }
+    auto it = std::find(ids.begin(), ids.end(), id);
+    return it != ids.end() ? static_cast<size_t>(it - ids.begin()) : npos;
+}
+
+std::string_view CompactMessageStore::contentAt(size_t pos) const {
+    return std::string_view(arena).substr(contentOffsets[pos], contentLengths[pos]);
+}
+
+std::string CompactMessageStore::attachmentAt(size_t pos) const {
+    if (!(flags[pos] & FLAG_ATTACHMENT)) return "";
+    auto it = attachments.find(pos);
+    return it != attachments.end() ? it->second : "";
+}
+
+bool CompactMessageStore::isReadBy(size_t pos, int userId) const {
+    auto it = readPositions.find(userId);
+    if (it == readPositions.end()) return false;
+    return std::binary_search(it->second.begin(), it->second.end(), static_cast<uint32_t>(pos));
+}
+
+ChatMessage CompactMessageStore::toChatMessage(size_t pos) const {
+    ChatMessage msg;
+    msg.id = ids[pos];
+    msg.senderId = senderIds[pos];
+    msg.content = std::string(contentAt(pos));
+    msg.attachmentPath = attachmentAt(pos);
+    msg.replyToMessageId = replyTo[pos];
+    msg.timestamp = timestamps[pos];
+    for (const auto& [userId, positions] : readPositions) {
+        if (std::binary_search(positions.begin(), positions.end(), static_cast<uint32_t>(pos))) {
+            msg.readBy.insert(userId);
+        }
+    }
+    return msg;
+}
+
+// ================== Scans ==================
+int CompactMessageStore::countUnread(int userId) const {
+    static const std::vector<uint32_t> none;
+    auto found = readPositions.find(userId);
+    const auto& positions = found != readPositions.end() ? found->second : none;
+
+    // Merge the flag column with the user's sorted read positions
+    int count = 0;
+    size_t next = 0;
+    for (size_t pos = 0; pos < flags.size(); pos++) {
+        while (next < positions.size() && positions[next] < pos) next++;
+        bool read = next < positions.size() && positions[next] == pos;
+        if (!read && !(flags[pos] & FLAG_DELETED)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::vector<size_t> CompactMessageStore::replies() const {
+    std::vector<size_t> result;
+    for (size_t pos = 0; pos < flags.size(); pos++) {
+        if ((flags[pos] & (FLAG_REPLY | FLAG_DELETED)) == FLAG_REPLY) {
+            result.push_back(pos);
+        }
+    }
+    return result;
+}
+
+std::vector<size_t> CompactMessageStore::inTimeRange(std::time_t from, std::time_t to) const {
+    std::vector<size_t> result;
+    for (size_t pos = 0; pos < timestamps.size(); pos++) {
+        if (timestamps[pos] >= from && timestamps[pos] <= to && !(flags[pos] & FLAG_DELETED)) {
+            result.push_back(pos);
+        }
+    }
+    return result;
+}
+
+size_t CompactMessageStore::memoryUsage() const {
+    size_t bytes = ids.capacity() * sizeof(int)
+                 + senderIds.capacity() * sizeof(int)
+                 + timestamps.capacity() * sizeof(std::time_t)
+                 + replyTo.capacity() * sizeof(int)
+                 + contentOffsets.capacity() * sizeof(uint32_t)
+                 + contentLengths.capacity() * sizeof(uint32_t)
+                 + flags.capacity()
+                 + arena.capacity();
+    for (const auto& [pos, path] : attachments) {
+        bytes += sizeof(pos) + sizeof(path) + path.capacity();
+    }
+    for (const auto& [userId, positions] : readPositions) {
+        bytes += sizeof(userId) + sizeof(positions) + positions.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,82 @@
+#ifndef COMPACTMESSAGESTORE_H
+#define COMPACTMESSAGESTORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+
+struct ChatMessage;
+
+// Structure-of-arrays message storage for a single room.
+// Hot scalar fields live in parallel contiguous arrays, message text lives in an
+// append-only arena, and rare fields (attachments) sit in a sparse side table.
+// Positions are stable: deleting a message only sets a tombstone flag.
+class CompactMessageStore {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    // ============ Mutation ============
+    size_t append(int id, int senderId, const std::string& content,
+                  std::time_t timestamp, int replyToMessageId = -1,
+                  const std::string& attachmentPath = "");
+    size_t append(const ChatMessage& message);
+    bool editContent(size_t pos, const std::string& newContent);
+    bool remove(size_t pos);
+    void markRead(size_t pos, int userId);
+    void compact();   // Rewrites the arena without the text of edited/deleted messages
+    void clear();
+
+    // ============ Lookup ============
+    size_t findPosition(int id) const;
+    size_t size() const { return ids.size(); }
+    size_t liveCount() const { return live; }
+    bool isDeleted(size_t pos) const { return (flags[pos] & FLAG_DELETED) != 0; }
+    int idAt(size_t pos) const { return ids[pos]; }
+    int senderAt(size_t pos) const { return senderIds[pos]; }
+    std::time_t timestampAt(size_t pos) const { return timestamps[pos]; }
+    int replyToAt(size_t pos) const { return replyTo[pos]; }
+    std::string_view contentAt(size_t pos) const;
+    std::string attachmentAt(size_t pos) const;
+    bool isReadBy(size_t pos, int userId) const;
+    ChatMessage toChatMessage(size_t pos) const;
+
+    // ============ Scans ============
+    int countUnread(int userId) const;
+    std::vector<size_t> replies() const;
+    std::vector<size_t> inTimeRange(std::time_t from, std::time_t to) const;
+
+    size_t memoryUsage() const;   // Approximate bytes held by all columns and side tables
+
+private:
+    enum : uint8_t {
+        FLAG_DELETED = 1 << 0,
+        FLAG_ATTACHMENT = 1 << 1,
+        FLAG_REPLY = 1 << 2
+    };
+
+    // ============ Columns (one entry per message) ============
+    std::vector<int> ids;
+    std::vector<int> senderIds;
+    std::vector<std::time_t> timestamps;
+    std::vector<int> replyTo;
+    std::vector<uint32_t> contentOffsets;
+    std::vector<uint32_t> contentLengths;
+    std::vector<uint8_t> flags;
+
+    // ============ Arena and side tables ============
+    std::string arena;                                   // Concatenated message text
+    size_t deadArenaBytes = 0;                           // Text no longer referenced
+    std::unordered_map<size_t, std::string> attachments; // Position -> attachment path
+    std::unordered_map<int, std::vector<uint32_t>> readPositions; // User -> sorted read positions
+
+    size_t live = 0;
+    bool idsAscending = true;   // Enables binary search in findPosition
+
+    uint32_t storeContent(const std::string& content);
+};
+
+#endif // COMPACTMESSAGESTORE_H
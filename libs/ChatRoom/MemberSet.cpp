@@ -0,0 +1,199 @@
+#include "MemberSet.h"
+#include <algorithm>
+
+static int64_t floorTo64(int64_t value) {
+    return value >= 0 ? value - value % 64 : -((-value + 63) / 64) * 64;
+}
+
+// ================== Representation Choice ==================
+bool MemberSet::denseEnough(int minId, int maxId, size_t members) const {
+    int64_t range = static_cast<int64_t>(maxId) - floorTo64(minId) + 1;
+    return static_cast<uint64_t>(range) <= members * BITS_PER_MEMBER;
+}
+
+void MemberSet::rebuild(const std::vector<int>& sortedIds) {
+    flat.clear();
+    bits.clear();
+    hashed.clear();
+    total = sortedIds.size();
+
+    if (total <= FLAT_LIMIT) {
+        mode = Representation::Flat;
+        flat = sortedIds;
+    } else if (denseEnough(sortedIds.front(), sortedIds.back(), total)) {
+        mode = Representation::Bitmap;
+        base = static_cast<int>(floorTo64(sortedIds.front()));
+        int64_t range = static_cast<int64_t>(sortedIds.back()) - base + 1;
+        bits.assign(static_cast<size_t>((range + 63) / 64), 0);
+        for (int id : sortedIds) {
+            int64_t offset = static_cast<int64_t>(id) - base;
+            bits[offset / 64] |= uint64_t(1) << (offset % 64);
+        }
+    } else {
+        mode = Representation::Hash;
+        hashed.reserve(total);
+        hashed.insert(sortedIds.begin(), sortedIds.end());
+    }
+}
+
+bool MemberSet::bitmapContains(int userId) const {
+    int64_t offset = static_cast<int64_t>(userId) - base;
+    if (offset < 0 || offset >= static_cast<int64_t>(bits.size()) * 64) return false;
+    return (bits[offset / 64] >> (offset % 64)) & 1;
+}
+
+// ================== Mutation ==================
+bool MemberSet::insert(int userId) {
+    switch (mode) {
+        case Representation::Flat: {
+            auto it = std::lower_bound(flat.begin(), flat.end(), userId);
+            if (it != flat.end() && *it == userId) return false;
+            flat.insert(it, userId);
+            total++;
+            if (total > FLAT_LIMIT) {
+                std::vector<int> sorted;
+                sorted.swap(flat);
+                rebuild(sorted);
+            }
+            return true;
+        }
+        case Representation::Bitmap: {
+            if (bitmapContains(userId)) return false;
+
+            int64_t offset = static_cast<int64_t>(userId) - base;
+            if (offset >= 0 && offset < static_cast<int64_t>(bits.size()) * 64) {
+                bits[offset / 64] |= uint64_t(1) << (offset % 64);
+                total++;
+                return true;
+            }
+
+            // Above the range (the usual case, new IDs grow): extend in place while still dense
+            if (offset > 0 && denseEnough(base, userId, total + 1)) {
+                bits.resize(static_cast<size_t>(offset / 64) + 1, 0);
+                bits[offset / 64] |= uint64_t(1) << (offset % 64);
+                total++;
+                return true;
+            }
+
+            // Below the range or too sparse: re-pick the representation
+            std::vector<int> sorted = toVector();
+            sorted.insert(std::lower_bound(sorted.begin(), sorted.end(), userId), userId);
+            rebuild(sorted);
+            return true;
+        }
+        case Representation::Hash: {
+            if (!hashed.insert(userId).second) return false;
+            total++;
+
+            // Check density occasionally (each time the size doubles)
+            if ((total & (total - 1)) == 0) {
+                auto range = std::minmax_element(hashed.begin(), hashed.end());
+                if (denseEnough(*range.first, *range.second, total)) {
+                    rebuild(toVector());
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MemberSet::erase(int userId) {
+    switch (mode) {
+        case Representation::Flat: {
+            auto it = std::lower_bound(flat.begin(), flat.end(), userId);
+            if (it == flat.end() || *it != userId) return false;
+            flat.erase(it);
+            total--;
+            return true;
+        }
+        case Representation::Bitmap: {
+            if (!bitmapContains(userId)) return false;
+            int64_t offset = static_cast<int64_t>(userId) - base;
+            bits[offset / 64] &= ~(uint64_t(1) << (offset % 64));
+            total--;
+
+            // Hysteresis: only leave the bitmap once it is half as dense as required to enter it
+            if (total <= FLAT_LIMIT / 2 || !denseEnough(base, base + static_cast<int>(bits.size() * 64) - 1, total * 2)) {
+                rebuild(toVector());
+            }
+            return true;
+        }
+        case Representation::Hash: {
+            if (!hashed.erase(userId)) return false;
+            total--;
+            if (total <= FLAT_LIMIT / 2) {
+                rebuild(toVector());
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemberSet::clear() {
+    flat.clear();
+    bits.clear();
+    hashed.clear();
+    total = 0;
+    mode = Representation::Flat;
+}
+
+// ================== Queries ==================
+bool MemberSet::contains(int userId) const {
+    switch (mode) {
+        case Representation::Flat:
+            return std::binary_search(flat.begin(), flat.end(), userId);
+        case Representation::Bitmap:
+            return bitmapContains(userId);
+        case Representation::Hash:
+            return hashed.count(userId) > 0;
+    }
+    return false;
+}
+
+std::vector<int> MemberSet::toVector() const {
+    if (mode == Representation::Flat) {
+        return flat;
+    }
+
+    std::vector<int> result;
+    result.reserve(total);
+    forEach([&result](int userId) { result.push_back(userId); });
+    if (mode == Representation::Hash) {
+        std::sort(result.begin(), result.end());
+    }
+    return result;
+}
+
+void MemberSet::forEach(const std::function<void(int)>& fn) const {
+    switch (mode) {
+        case Representation::Flat:
+            for (int userId : flat) fn(userId);
+            break;
+        case Representation::Bitmap:
+            for (size_t word = 0; word < bits.size(); word++) {
+                uint64_t w = bits[word];
+                for (int bit = 0; w != 0; bit++, w >>= 1) {
+                    if (w & 1) fn(base + static_cast<int>(word * 64) + bit);
+                }
+            }
+            break;
+        case Representation::Hash:
+            for (int userId : hashed) fn(userId);
+            break;
+    }
+}
+
+size_t MemberSet::memoryUsage() const {
+    switch (mode) {
+        case Representation::Flat:
+            return flat.capacity() * sizeof(int);
+        case Representation::Bitmap:
+            return bits.capacity() * sizeof(uint64_t);
+        case Representation::Hash:
+            // Buckets plus one node (next pointer + value, padded) per element
+            return hashed.bucket_count() * sizeof(void*) + hashed.size() * 2 * sizeof(void*);
+    }
+    return 0;
+}
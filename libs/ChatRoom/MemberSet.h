@@ -0,0 +1,50 @@
+#ifndef MEMBERSET_H
+#define MEMBERSET_H
+
+#include <vector>
+#include <unordered_set>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// Set of user IDs whose representation follows the room size:
+//   Flat   - sorted vector, for small rooms (fits a few cache lines)
+//   Bitmap - one bit per ID over [base, base + bits), when IDs are dense
+//   Hash   - unordered_set, for large rooms with scattered IDs
+// Switching happens on insert/erase and is invisible to callers.
+class MemberSet {
+public:
+    enum class Representation { Flat, Bitmap, Hash };
+
+    bool insert(int userId);          // False if already present
+    bool erase(int userId);           // False if not present
+    bool contains(int userId) const;
+    size_t count(int userId) const { return contains(userId) ? 1 : 0; }
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+    void clear();
+
+    std::vector<int> toVector() const;     // Ascending order
+    void forEach(const std::function<void(int)>& fn) const;  // Ascending except in Hash mode
+
+    Representation representation() const { return mode; }
+    size_t memoryUsage() const;
+
+private:
+    static const size_t FLAT_LIMIT = 128;        // Above this, leave the flat vector
+    static const size_t BITS_PER_MEMBER = 32;    // Bitmap allowed while range <= 32 bits per member
+
+    Representation mode = Representation::Flat;
+    size_t total = 0;
+
+    std::vector<int> flat;                 // Sorted, Flat mode
+    std::vector<uint64_t> bits;            // Bitmap mode
+    int base = 0;                          // ID of bit 0 (multiple of 64)
+    std::unordered_set<int> hashed;        // Hash mode
+
+    bool denseEnough(int minId, int maxId, size_t members) const;
+    void rebuild(const std::vector<int>& sortedIds);  // Picks the best representation
+    bool bitmapContains(int userId) const;
+};
+
+#endif // MEMBERSET_H
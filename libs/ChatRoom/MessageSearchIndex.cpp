@@ -0,0 +1,270 @@
+#include "MessageSearchIndex.h"
+#include <algorithm>
+#include <set>
+
+// ================== Tokenizer ==================
+std::vector<std::string> MessageSearchIndex::tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string current;
+
+    auto flush = [&]() {
+        if (!current.empty()) {
+            if (current.size() > MAX_TOKEN_LENGTH) {
+                current.resize(MAX_TOKEN_LENGTH);
+            }
+            tokens.push_back(current);
+            current.clear();
+        }
+    };
+
+    for (unsigned char c : text) {
+        if (c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) {
+            current.push_back(static_cast<char>(c));
+        } else if (c >= 'A' && c <= 'Z') {
+            current.push_back(static_cast<char>(c - 'A' + 'a'));
+        } else {
+            flush();
+        }
+    }
+    flush();
+    return tokens;
+}
+
+// ================== Maintenance ==================
+void MessageSearchIndex::addMessage(int messageId, const std::string& content) {
+    if (messageId <= 0) return;  // Deltas assume positive, ascending ids
+
+    auto tokens = tokenize(content);
+    std::set<std::string> unique(tokens.begin(), tokens.end());
+    for (const auto& token : unique) {
+        insertSorted(terms[token], messageId);
+    }
+}
+
+void MessageSearchIndex::removeMessage(int messageId, const std::string& content) {
+    auto tokens = tokenize(content);
+    std::set<std::string> unique(tokens.begin(), tokens.end());
+    for (const auto& token : unique) {
+        auto it = terms.find(token);
+        if (it == terms.end()) continue;
+
+        erase(it->second, messageId);
+        if (it->second.count == 0) {
+            terms.erase(it);
+        }
+    }
+}
+
+void MessageSearchIndex::updateMessage(int messageId, const std::string& oldContent,
+                                       const std::string& newContent) {
+    auto oldTokens = tokenize(oldContent);
+    auto newTokens = tokenize(newContent);
+    std::set<std::string> before(oldTokens.begin(), oldTokens.end());
+    std::set<std::string> after(newTokens.begin(), newTokens.end());
+
+    // Only touch the posting lists of tokens that actually changed
+    for (const auto& token : before) {
+        if (after.count(token)) continue;
+        auto it = terms.find(token);
+        if (it == terms.end()) continue;
+        erase(it->second, messageId);
+        if (it->second.count == 0) {
+            terms.erase(it);
+        }
+    }
+    for (const auto& token : after) {
+        if (before.count(token)) continue;
+        insertSorted(terms[token], messageId);
+    }
+}
+
+void MessageSearchIndex::clear() {
+    terms.clear();
+}
+
+// ================== Queries ==================
+bool MessageSearchIndex::search(const std::string& query, std::vector<int>& messageIds,
+                                size_t offset, size_t limit) const {
+    messageIds.clear();
+
+    auto tokens = tokenize(query);
+    if (tokens.empty()) {
+        return false;
+    }
+
+    std::vector<PrefixCursor> cursors;
+    cursors.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        cursors.emplace_back(*this, token);
+        if (!cursors.back().valid()) {
+            return true;
+        }
+    }
+
+    // Leapfrog intersection: every cursor seeks to the largest current id until all agree
+    size_t skipped = 0;
+    while (messageIds.size() < limit) {
+        int candidate = cursors[0].value();
+        bool agreed = true;
+        for (size_t i = 1; i < cursors.size(); i++) {
+            cursors[i].seek(candidate);
+            if (!cursors[i].valid()) {
+                return true;
+            }
+            if (cursors[i].value() != candidate) {
+                cursors[0].seek(cursors[i].value());
+                agreed = false;
+                break;
+            }
+        }
+        if (agreed) {
+            if (skipped < offset) {
+                skipped++;
+            } else {
+                messageIds.push_back(candidate);
+            }
+            cursors[0].advance();
+        }
+        if (!cursors[0].valid()) {
+            break;
+        }
+    }
+    return true;
+}
+
+size_t MessageSearchIndex::termCount() const {
+    return terms.size();
+}
+
+size_t MessageSearchIndex::memoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& [term, list] : terms) {
+        bytes += term.capacity() + list.bytes.capacity() + sizeof(PostingList);
+    }
+    return bytes;
+}
+
+// ================== Cursors ==================
+bool MessageSearchIndex::ListCursor::next() {
+    uint32_t delta = 0;
+    int shift = 0;
+    while (pos < list->bytes.size()) {
+        uint8_t byte = list->bytes[pos++];
+        delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            current += static_cast<int>(delta);
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+bool MessageSearchIndex::laterThan(const ListCursor& a, const ListCursor& b) {
+    return a.current > b.current;
+}
+
+MessageSearchIndex::PrefixCursor::PrefixCursor(const MessageSearchIndex& index, const std::string& prefix) {
+    for (auto it = index.terms.lower_bound(prefix);
+         it != index.terms.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        ListCursor cursor{&it->second};
+        if (cursor.next()) {
+            heap.push_back(cursor);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), laterThan);
+}
+
+void MessageSearchIndex::PrefixCursor::advance() {
+    int passed = value();
+    // The same id can sit at the head of several lists (a message with two matching words)
+    while (!heap.empty() && heap.front().current == passed) {
+        std::pop_heap(heap.begin(), heap.end(), laterThan);
+        if (heap.back().next()) {
+            std::push_heap(heap.begin(), heap.end(), laterThan);
+        } else {
+            heap.pop_back();
+        }
+    }
+}
+
+void MessageSearchIndex::PrefixCursor::seek(int messageId) {
+    while (!heap.empty() && heap.front().current < messageId) {
+        std::pop_heap(heap.begin(), heap.end(), laterThan);
+        ListCursor& cursor = heap.back();
+        bool more = true;
+        while (cursor.current < messageId && (more = cursor.next())) {
+        }
+        if (more) {
+            std::push_heap(heap.begin(), heap.end(), laterThan);
+        } else {
+            heap.pop_back();
+        }
+    }
+}
+
+// ================== Posting List Encoding ==================
+void MessageSearchIndex::append(PostingList& list, int messageId) {
+    uint32_t delta = static_cast<uint32_t>(messageId - list.lastId);
+    while (delta >= 0x80) {
+        list.bytes.push_back(static_cast<uint8_t>(delta | 0x80));
+        delta >>= 7;
+    }
+    list.bytes.push_back(static_cast<uint8_t>(delta));
+    list.lastId = messageId;
+    list.count++;
+}
+
+std::vector<int> MessageSearchIndex::decode(const PostingList& list) {
+    std::vector<int> ids;
+    ids.reserve(list.count);
+
+    int current = 0;
+    uint32_t delta = 0;
+    int shift = 0;
+    for (uint8_t byte : list.bytes) {
+        delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (byte & 0x80) {
+            shift += 7;
+            continue;
+        }
+        current += static_cast<int>(delta);
+        ids.push_back(current);
+        delta = 0;
+        shift = 0;
+    }
+    return ids;
+}
+
+MessageSearchIndex::PostingList MessageSearchIndex::encode(const std::vector<int>& ids) {
+    PostingList list;
+    for (int id : ids) {
+        append(list, id);
+    }
+    return list;
+}
+
+void MessageSearchIndex::insertSorted(PostingList& list, int messageId) {
+    if (messageId > list.lastId) {
+        append(list, messageId);
+        return;
+    }
+
+    auto ids = decode(list);
+    auto pos = std::lower_bound(ids.begin(), ids.end(), messageId);
+    if (pos != ids.end() && *pos == messageId) {
+        return;
+    }
+    ids.insert(pos, messageId);
+    list = encode(ids);
+}
+
+void MessageSearchIndex::erase(PostingList& list, int messageId) {
+    auto ids = decode(list);
+    auto pos = std::lower_bound(ids.begin(), ids.end(), messageId);
+    if (pos == ids.end() || *pos != messageId) {
+        return;
+    }
+    ids.erase(pos);
+    list = encode(ids);
+}
@@ -0,0 +1,73 @@
+#ifndef MESSAGESEARCHINDEX_H
+#define MESSAGESEARCHINDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+// Token -> posting list index over the messages of a single room.
+// Posting lists hold ascending message ids, delta + varint encoded.
+class MessageSearchIndex {
+public:
+    // ============ Maintenance ============
+    void addMessage(int messageId, const std::string& content);
+    void removeMessage(int messageId, const std::string& content);
+    void updateMessage(int messageId, const std::string& oldContent, const std::string& newContent);
+    void clear();
+
+    // ============ Queries ============
+    // Every query token must prefix-match a token of the message (case-insensitive).
+    // Returns false when the query has no indexable tokens. Posting lists are merged and
+    // intersected lazily, so work and memory stop at offset + limit matches.
+    bool search(const std::string& query, std::vector<int>& messageIds,
+                size_t offset = 0, size_t limit = SIZE_MAX) const;
+
+    size_t termCount() const;
+    size_t memoryUsage() const;  // Approximate bytes held by terms and posting lists
+
+    // Lower-cased tokens; bytes >= 0x80 are kept so UTF-8 words stay whole
+    static std::vector<std::string> tokenize(const std::string& text);
+
+private:
+    struct PostingList {
+        std::vector<uint8_t> bytes;  // Varint deltas between consecutive ids
+        int lastId = 0;              // Largest id in the list (base for the next delta)
+        size_t count = 0;
+    };
+
+    std::map<std::string, PostingList> terms;
+
+    static const size_t MAX_TOKEN_LENGTH = 32;
+
+    // Streams the ids of one posting list in ascending order
+    struct ListCursor {
+        const PostingList* list;
+        size_t pos = 0;
+        int current = 0;
+        bool next();    // Moves to the next id; false at the end of the list
+    };
+    // std heap functions build a max-heap; this ordering makes it a min-heap on current
+    static bool laterThan(const ListCursor& a, const ListCursor& b);
+
+    // Streams the union of every posting list whose term starts with a prefix (ascending, unique)
+    class PrefixCursor {
+    public:
+        PrefixCursor(const MessageSearchIndex& index, const std::string& prefix);
+        bool valid() const { return !heap.empty(); }
+        int value() const { return heap.front().current; }
+        void advance();             // Past the current id
+        void seek(int messageId);   // To the first id >= messageId
+    private:
+        std::vector<ListCursor> heap;   // Min-heap on current
+    };
+
+    static void append(PostingList& list, int messageId);
+    static std::vector<int> decode(const PostingList& list);
+    static PostingList encode(const std::vector<int>& ids);
+    static void insertSorted(PostingList& list, int messageId);
+    static void erase(PostingList& list, int messageId);
+};
+
+#endif // MESSAGESEARCHINDEX_H
@@ -0,0 +1,173 @@
+#include "SubscriberBitmap.h"
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int countTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// ================== Container ==================
+bool SubscriberBitmap::Container::contains(uint16_t low) const {
+    if (isBitmap()) {
+        return (bitmap[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+bool SubscriberBitmap::Container::add(uint16_t low) {
+    if (isBitmap()) {
+        uint64_t mask = uint64_t(1) << (low & 63);
+        if (bitmap[low >> 6] & mask) return false;
+        bitmap[low >> 6] |= mask;
+        cardinality++;
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) return false;
+    array.insert(it, low);
+    cardinality++;
+
+    if (array.size() > ARRAY_LIMIT) {
+        toBitmap();
+    }
+    return true;
+}
+
+bool SubscriberBitmap::Container::remove(uint16_t low) {
+    if (isBitmap()) {
+        uint64_t mask = uint64_t(1) << (low & 63);
+        if (!(bitmap[low >> 6] & mask)) return false;
+        bitmap[low >> 6] &= ~mask;
+        cardinality--;
+
+        if (cardinality <= ARRAY_LIMIT / 2) {
+            toArray();
+        }
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it == array.end() || *it != low) return false;
+    array.erase(it);
+    cardinality--;
+    return true;
+}
+
+void SubscriberBitmap::Container::toBitmap() {
+    bitmap.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : array) {
+        bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    std::vector<uint16_t>().swap(array);
+}
+
+void SubscriberBitmap::Container::toArray() {
+    std::vector<uint16_t> values;
+    values.reserve(cardinality);
+    for (size_t word = 0; word < BITMAP_WORDS; word++) {
+        uint64_t bits = bitmap[word];
+        while (bits) {
+            int bit = countTrailingZeros(bits);
+            values.push_back(static_cast<uint16_t>(word * 64 + bit));
+            bits &= bits - 1;
+        }
+    }
+    array.swap(values);
+    std::vector<uint64_t>().swap(bitmap);
+}
+
+// ================== SubscriberBitmap ==================
+long SubscriberBitmap::findKey(uint16_t high) const {
+    auto it = std::lower_bound(keys.begin(), keys.end(), high);
+    if (it == keys.end() || *it != high) return -1;
+    return it - keys.begin();
+}
+
+bool SubscriberBitmap::add(int userId) {
+    if (userId < 0) return false;
+
+    uint16_t high = static_cast<uint16_t>(static_cast<uint32_t>(userId) >> 16);
+    uint16_t low = static_cast<uint16_t>(userId & 0xffff);
+
+    auto it = std::lower_bound(keys.begin(), keys.end(), high);
+    size_t index = it - keys.begin();
+    if (it == keys.end() || *it != high) {
+        keys.insert(it, high);
+        containers.insert(containers.begin() + index, Container());
+    }
+
+    if (!containers[index].add(low)) return false;
+    count++;
+    return true;
+}
+
+bool SubscriberBitmap::remove(int userId) {
+    if (userId < 0) return false;
+
+    long index = findKey(static_cast<uint16_t>(static_cast<uint32_t>(userId) >> 16));
+    if (index < 0) return false;
+
+    Container& container = containers[index];
+    if (!container.remove(static_cast<uint16_t>(userId & 0xffff))) return false;
+    count--;
+
+    if (container.cardinality == 0) {
+        keys.erase(keys.begin() + index);
+        containers.erase(containers.begin() + index);
+    }
+    return true;
+}
+
+bool SubscriberBitmap::contains(int userId) const {
+    if (userId < 0) return false;
+
+    long index = findKey(static_cast<uint16_t>(static_cast<uint32_t>(userId) >> 16));
+    return index >= 0 && containers[index].contains(static_cast<uint16_t>(userId & 0xffff));
+}
+
+std::vector<int> SubscriberBitmap::toVector() const {
+    std::vector<int> result;
+    result.reserve(count);
+    for (size_t i = 0; i < keys.size(); i++) {
+        int base = static_cast<int>(static_cast<uint32_t>(keys[i]) << 16);
+        const Container& container = containers[i];
+        if (container.isBitmap()) {
+            for (size_t word = 0; word < BITMAP_WORDS; word++) {
+                uint64_t bits = container.bitmap[word];
+                while (bits) {
+                    result.push_back(base + static_cast<int>(word * 64 + countTrailingZeros(bits)));
+                    bits &= bits - 1;
+                }
+            }
+        } else {
+            for (uint16_t low : container.array) {
+                result.push_back(base + low);
+            }
+        }
+    }
+    return result;
+}
+
+size_t SubscriberBitmap::memoryUsage() const {
+    size_t bytes = keys.capacity() * sizeof(uint16_t) + containers.capacity() * sizeof(Container);
+    for (const auto& container : containers) {
+        bytes += container.array.capacity() * sizeof(uint16_t)
+               + container.bitmap.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void SubscriberBitmap::clear() {
+    keys.clear();
+    containers.clear();
+    count = 0;
+}
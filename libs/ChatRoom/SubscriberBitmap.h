@@ -0,0 +1,46 @@
+#ifndef SUBSCRIBERBITMAP_H
+#define SUBSCRIBERBITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Compressed set of non-negative user IDs (roaring-style).
+// IDs are split by their high 16 bits into chunks; each chunk is a sorted
+// array while sparse and switches to a 65536-bit bitmap once it gets dense.
+class SubscriberBitmap {
+public:
+    bool add(int userId);         // False if already present or negative
+    bool remove(int userId);      // False if not present
+    bool contains(int userId) const;
+    size_t cardinality() const { return count; }
+    bool empty() const { return count == 0; }
+    std::vector<int> toVector() const;   // Ascending order
+    size_t memoryUsage() const;
+    void clear();
+
+private:
+    static const size_t ARRAY_LIMIT = 4096;   // Above this a bitmap is smaller than the array
+    static const size_t BITMAP_WORDS = 65536 / 64;
+
+    struct Container {
+        std::vector<uint16_t> array;    // Sorted low bits while sparse
+        std::vector<uint64_t> bitmap;   // BITMAP_WORDS words once dense
+        uint32_t cardinality = 0;
+
+        bool isBitmap() const { return !bitmap.empty(); }
+        bool contains(uint16_t low) const;
+        bool add(uint16_t low);
+        bool remove(uint16_t low);
+        void toBitmap();
+        void toArray();
+    };
+
+    std::vector<uint16_t> keys;           // Sorted high bits
+    std::vector<Container> containers;    // Parallel to keys
+    size_t count = 0;
+
+    long findKey(uint16_t high) const;    // Index in keys, or -1
+};
+
+#endif // SUBSCRIBERBITMAP_H
@@ -1,10 +1,11 @@
 #include "Database.h"
+#include "Logger.h"
 #include <sqlite3.h>
-#include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <ctime>
 #include <iomanip>
+#include <cstdint>
 
 Database::Database(const std::string& dbPath) : dbConnection(nullptr) {
     connect(dbPath);
@@ -22,12 +23,12 @@ void Database::connect(const std::string& dbPath) {
     int rc = sqlite3_open(dbPath.c_str(), &db);
     
     if (rc != SQLITE_OK) {
-        std::cerr << "Cannot open database: " << sqlite3_errmsg(db) << std::endl;
+        LOG_ERROR("db.open", std::string("Cannot open database: ") + sqlite3_errmsg(db));
         sqlite3_close(db);
         dbConnection = nullptr;
     } else {
         dbConnection = db;
-        std::cout << "Database opened successfully" << std::endl;
+        LOG_INFO("db.open", "Database opened successfully");
     }
 }
 
@@ -77,6 +78,20 @@ void Database::initializeSchema() {
             FOREIGN KEY (sender) REFERENCES users(username)
         );
         
+        -- Shared, immutable message bodies (forwards reference these by hash)
+        CREATE TABLE IF NOT EXISTS message_bodies (
+            hash TEXT PRIMARY KEY,
+            content TEXT NOT NULL
+        );
+        
+        -- Pending reminders, removed once delivered
+        CREATE TABLE IF NOT EXISTS reminders (
+            id TEXT PRIMARY KEY,
+            username TEXT NOT NULL,
+            title TEXT NOT NULL,
+            due_at INTEGER NOT NULL
+        );
+        
         -- Indexes for better performance
         CREATE INDEX IF NOT EXISTS idx_messages_sender ON messages(sender);
         CREATE INDEX IF NOT EXISTS idx_messages_receiver ON messages(receiver);
@@ -87,7 +102,48 @@ void Database::initializeSchema() {
     int rc = sqlite3_exec(db, createTables, nullptr, nullptr, &errMsg);
     
     if (rc != SQLITE_OK) {
-        std::cerr << "SQL error: " << errMsg << std::endl;
+        LOG_ERROR("db.sql", std::string("SQL error: ") + errMsg);
+        sqlite3_free(errMsg);
+    }
+
+    // Columns added after the first schema version
+    addColumnIfMissing("messages", "body_hash", "TEXT");
+    addColumnIfMissing("messages", "forwarded_from", "INTEGER");
+    addColumnIfMissing("messages", "forward_origin", "TEXT");
+    addColumnIfMissing("messages", "is_delivered", "BOOLEAN DEFAULT FALSE");
+    addColumnIfMissing("messages", "client_id", "TEXT");
+    
+    // Client keys are chosen by senders, so they only need to be unique per sender.
+    // NULLs are distinct in a unique index, so rows without a client id are unaffected.
+    if (sqlite3_exec(db, "DROP INDEX IF EXISTS idx_messages_client_id; "
+                         "CREATE UNIQUE INDEX IF NOT EXISTS idx_messages_sender_client_id ON messages(sender, client_id)",
+                     nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        LOG_ERROR("db.sql", std::string("SQL error: ") + errMsg);
+        sqlite3_free(errMsg);
+    }
+}
+
+void Database::addColumnIfMissing(const std::string& table, const std::string& column, const std::string& type) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    
+    std::string pragma = "PRAGMA table_info(" + table + ")";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, pragma.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return;
+    
+    bool found = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (column == reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1))) {
+            found = true;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (found) return;
+    
+    std::string alter = "ALTER TABLE " + table + " ADD COLUMN " + column + " " + type;
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, alter.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        LOG_ERROR("db.sql", std::string("SQL error: ") + errMsg);
         sqlite3_free(errMsg);
     }
 }
@@ -175,7 +231,49 @@ bool Database::addUserToChatroom(const std::string& username, const std::string&
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) return false;
+    publish({ChangeType::MemberAdded, -1, username, chatroomName, ""});
+    return true;
+}
+
+std::vector<bool> Database::addUsersToChatroom(const std::vector<std::string>& usernames, const std::string& chatroomName) {
+    std::vector<bool> results(usernames.size(), false);
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db || usernames.empty()) return results;
+    
+    if (sqlite3_exec(db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return results;
+    }
+    
+    const char* sql = "INSERT INTO chatroom_members (username, chatroom_name) VALUES (?, ?)";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return results;
+    }
+    
+    // One prepared statement reused for every row
+    sqlite3_bind_text(stmt, 2, chatroomName.c_str(), -1, SQLITE_STATIC);
+    for (size_t i = 0; i < usernames.size(); i++) {
+        sqlite3_bind_text(stmt, 1, usernames[i].c_str(), -1, SQLITE_STATIC);
+        results[i] = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    
+    if (sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return std::vector<bool>(usernames.size(), false);
+    }
+    
+    for (size_t i = 0; i < usernames.size(); i++) {
+        if (results[i]) {
+            publish({ChangeType::MemberAdded, -1, usernames[i], chatroomName, ""});
+        }
+    }
+    return results;
 }
 
 bool Database::sendMessage(const std::string& sender, const std::string& receiver, const std::string& content) {
@@ -195,14 +293,18 @@ bool Database::sendMessage(const std::string& sender, const std::string& receive
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) return false;
+    int messageId = static_cast<int>(sqlite3_last_insert_rowid(db));
+    publish({ChangeType::MessageInserted, messageId, sender, receiver, content});
+    return true;
 }
 
 bool Database::editMessage(int messageId, const std::string& newContent) {
     sqlite3* db = static_cast<sqlite3*>(dbConnection);
     if (!db) return false;
     
-    const char* sql = "UPDATE messages SET content = ?, is_edited = TRUE WHERE id = ?";
+    // RETURNING gives subscribers the conversation without a second lookup
+    const char* sql = "UPDATE messages SET content = ?, body_hash = NULL, is_edited = TRUE WHERE id = ? RETURNING sender, receiver";
     sqlite3_stmt* stmt;
     
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -211,17 +313,28 @@ bool Database::editMessage(int messageId, const std::string& newContent) {
     sqlite3_bind_text(stmt, 1, newContent.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 2, messageId);
     
+    rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    ChangeEvent event{ChangeType::MessageEdited, messageId,
+                      reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                      reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                      newContent};
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
+    if (rc != SQLITE_DONE) return false;
+    publish(event);
+    return true;
 }
 
 bool Database::markMessageAsRead(int messageId) {
     sqlite3* db = static_cast<sqlite3*>(dbConnection);
     if (!db) return false;
     
-    const char* sql = "UPDATE messages SET is_read = TRUE WHERE id = ?";
+    const char* sql = "UPDATE messages SET is_read = TRUE WHERE id = ? RETURNING sender, receiver";
     sqlite3_stmt* stmt;
     
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -229,10 +342,231 @@ bool Database::markMessageAsRead(int messageId) {
     
     sqlite3_bind_int(stmt, 1, messageId);
     
+    rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    ChangeEvent event{ChangeType::MessageRead, messageId,
+                      reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                      reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                      ""};
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
+    if (rc != SQLITE_DONE) return false;
+    publish(event);
+    return true;
+}
+
+int Database::storeMessageOnce(const std::string& clientId, const std::string& sender,
+                               const std::string& receiver, const std::string& content) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db || clientId.empty()) return -1;
+    
+    // A retry of a recent send never reaches SQLite
+    std::string dedupKey = sender + '\x1f' + clientId;
+    if (std::optional<int> known = recentClientIds.find(dedupKey)) {
+        return *known;
+    }
+    
+    const char* sql = "INSERT INTO messages (sender, receiver, content, client_id) VALUES (?, ?, ?, ?) "
+                      "ON CONFLICT(sender, client_id) DO NOTHING";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return -1;
+    
+    sqlite3_bind_text(stmt, 1, sender.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, receiver.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, content.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, clientId.c_str(), -1, SQLITE_STATIC);
+    
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) return -1;
+    
+    if (sqlite3_changes(db) == 1) {
+        int messageId = static_cast<int>(sqlite3_last_insert_rowid(db));
+        recentClientIds.remember(dedupKey, messageId);
+        publish({ChangeType::MessageInserted, messageId, sender, receiver, content});
+        return messageId;
+    }
+    
+    // Already stored by an earlier attempt (older than the window, or before a restart)
+    int messageId = findMessageByClientId(sender, clientId);
+    if (messageId > 0) {
+        recentClientIds.remember(dedupKey, messageId);
+    }
+    return messageId;
+}
+
+int Database::findMessageByClientId(const std::string& sender, const std::string& clientId) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db || clientId.empty()) return -1;
+    
+    const char* sql = "SELECT id FROM messages WHERE sender = ? AND client_id = ?";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return -1;
+    
+    sqlite3_bind_text(stmt, 1, sender.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, clientId.c_str(), -1, SQLITE_STATIC);
+    int messageId = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+    sqlite3_finalize(stmt);
+    return messageId;
+}
+
+int Database::applyReceiptWatermarks(const std::vector<ReceiptWatermark>& watermarks) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db) return -1;
+    if (watermarks.empty()) return 0;
+    
+    if (sqlite3_exec(db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return -1;
+    }
+    
+    const char* seenSql = "UPDATE messages SET is_read = TRUE, is_delivered = TRUE "
+                          "WHERE sender = ? AND receiver = ? AND id <= ? AND is_read = FALSE RETURNING id";
+    const char* deliveredSql = "UPDATE messages SET is_delivered = TRUE "
+                               "WHERE sender = ? AND receiver = ? AND id <= ? AND is_delivered = FALSE";
+    sqlite3_stmt* seenStmt = nullptr;
+    sqlite3_stmt* deliveredStmt = nullptr;
+    if (sqlite3_prepare_v2(db, seenSql, -1, &seenStmt, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, deliveredSql, -1, &deliveredStmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(seenStmt);
+        sqlite3_finalize(deliveredStmt);
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return -1;
+    }
+    
+    // Two prepared statements reused for every conversation
+    int changed = 0;
+    bool ok = true;
+    std::vector<ChangeEvent> events;
+    for (const ReceiptWatermark& mark : watermarks) {
+        if (mark.seenUpTo > 0) {
+            sqlite3_bind_text(seenStmt, 1, mark.sender.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(seenStmt, 2, mark.receiver.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(seenStmt, 3, mark.seenUpTo);
+            int rc;
+            while ((rc = sqlite3_step(seenStmt)) == SQLITE_ROW) {
+                events.push_back({ChangeType::MessageRead, sqlite3_column_int(seenStmt, 0),
+                                  mark.sender, mark.receiver, ""});
+                changed++;
+            }
+            ok = ok && rc == SQLITE_DONE;
+            sqlite3_reset(seenStmt);
+        }
+        if (mark.deliveredUpTo > mark.seenUpTo) {
+            sqlite3_bind_text(deliveredStmt, 1, mark.sender.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(deliveredStmt, 2, mark.receiver.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(deliveredStmt, 3, mark.deliveredUpTo);
+            ok = ok && sqlite3_step(deliveredStmt) == SQLITE_DONE;
+            changed += sqlite3_changes(db);
+            sqlite3_reset(deliveredStmt);
+        }
+        if (!ok) break;
+    }
+    sqlite3_finalize(seenStmt);
+    sqlite3_finalize(deliveredStmt);
+    
+    if (!ok || sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return -1;
+    }
+    
+    for (const ChangeEvent& event : events) {
+        publish(event);
+    }
+    return changed;
+}
+
+// 64-bit FNV-1a: unlike std::hash it is fixed across builds, so stored body keys stay valid
+static std::string bodyHash(const std::string& content) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    std::ostringstream hashStream;
+    hashStream << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return hashStream.str();
+}
+
+bool Database::forwardMessage(const std::string& sender, const std::string& receiver, const std::string& content,
+                              int originalMessageId, const std::string& origin, const std::string& clientId) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db) return false;
+    
+    std::string hash = bodyHash(content);
+    
+    // The body and the row pointing at it commit together
+    if (sqlite3_exec(db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    auto rollback = [db]() {
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return false;
+    };
+    
+    // Store the body once; viral forwards only add a row that points at it
+    const char* bodySql = "INSERT OR IGNORE INTO message_bodies (hash, content) VALUES (?, ?)";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, bodySql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return rollback();
+    
+    sqlite3_bind_text(stmt, 1, hash.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, content.c_str(), -1, SQLITE_STATIC);
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) return rollback();
+    
+    // On a hash collision keep the text inline instead of pointing at someone else's body
+    const char* checkSql = "SELECT content = ? FROM message_bodies WHERE hash = ?";
+    rc = sqlite3_prepare_v2(db, checkSql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return rollback();
+    
+    sqlite3_bind_text(stmt, 1, content.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, hash.c_str(), -1, SQLITE_STATIC);
+    bool shared = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) != 0;
+    sqlite3_finalize(stmt);
+    
+    const char* sql = R"(
+        INSERT INTO messages (sender, receiver, content, body_hash, forwarded_from, forward_origin, client_id)
+        VALUES (?, ?, ?, ?, ?, ?, ?)
+    )";
+    rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return rollback();
+    
+    sqlite3_bind_text(stmt, 1, sender.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, receiver.c_str(), -1, SQLITE_STATIC);
+    if (shared) {
+        sqlite3_bind_text(stmt, 3, "", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, hash.c_str(), -1, SQLITE_STATIC);
+    } else {
+        sqlite3_bind_text(stmt, 3, content.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_null(stmt, 4);
+    }
+    sqlite3_bind_int(stmt, 5, originalMessageId);
+    sqlite3_bind_text(stmt, 6, origin.c_str(), -1, SQLITE_STATIC);
+    if (clientId.empty()) {
+        sqlite3_bind_null(stmt, 7);
+    } else {
+        sqlite3_bind_text(stmt, 7, clientId.c_str(), -1, SQLITE_STATIC);
+    }
+    
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    
+    if (rc != SQLITE_DONE) return rollback();
+    int messageId = static_cast<int>(sqlite3_last_insert_rowid(db));
+    if (sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) return rollback();
+    
+    publish({ChangeType::MessageInserted, messageId, sender, receiver, content});
+    return true;
 }
 
 std::vector<Message> Database::getMessageHistory(const std::string& user1, const std::string& user2) {
@@ -241,10 +575,12 @@ std::vector<Message> Database::getMessageHistory(const std::string& user1, const
     if (!db) return messages;
     
     const char* sql = R"(
-        SELECT id, sender, receiver, content, timestamp, is_read, is_edited 
-        FROM messages 
-        WHERE (sender = ? AND receiver = ?) OR (sender = ? AND receiver = ?)
-        ORDER BY timestamp ASC
+        SELECT m.id, m.sender, m.receiver, COALESCE(b.content, m.content), m.timestamp,
+               m.is_read, m.is_edited, m.forwarded_from, m.forward_origin
+        FROM messages m
+        LEFT JOIN message_bodies b ON b.hash = m.body_hash
+        WHERE (m.sender = ? AND m.receiver = ?) OR (m.sender = ? AND m.receiver = ?)
+        ORDER BY m.timestamp ASC
     )";
     
     sqlite3_stmt* stmt;
@@ -265,6 +601,10 @@ std::vector<Message> Database::getMessageHistory(const std::string& user1, const
         msg.timestamp = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
         msg.isRead = sqlite3_column_int(stmt, 5) != 0;
         msg.isEdited = sqlite3_column_int(stmt, 6) != 0;
+        if (sqlite3_column_type(stmt, 7) != SQLITE_NULL) {
+            msg.forwardedFrom = sqlite3_column_int(stmt, 7);
+            msg.forwardOrigin = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
+        }
         
         messages.push_back(msg);
     }
@@ -279,10 +619,12 @@ std::vector<Message> Database::getChatroomMessages(const std::string& chatroomNa
     if (!db) return messages;
     
     const char* sql = R"(
-        SELECT id, sender, receiver, content, timestamp, is_read, is_edited 
-        FROM messages 
-        WHERE receiver = ?
-        ORDER BY timestamp ASC
+        SELECT m.id, m.sender, m.receiver, COALESCE(b.content, m.content), m.timestamp,
+               m.is_read, m.is_edited, m.forwarded_from, m.forward_origin
+        FROM messages m
+        LEFT JOIN message_bodies b ON b.hash = m.body_hash
+        WHERE m.receiver = ?
+        ORDER BY m.timestamp ASC
     )";
     
     sqlite3_stmt* stmt;
@@ -300,6 +642,10 @@ std::vector<Message> Database::getChatroomMessages(const std::string& chatroomNa
         msg.timestamp = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
         msg.isRead = sqlite3_column_int(stmt, 5) != 0;
         msg.isEdited = sqlite3_column_int(stmt, 6) != 0;
+        if (sqlite3_column_type(stmt, 7) != SQLITE_NULL) {
+            msg.forwardedFrom = sqlite3_column_int(stmt, 7);
+            msg.forwardOrigin = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
+        }
         
         messages.push_back(msg);
     }
@@ -363,7 +709,8 @@ std::vector<Chat> Database::getUserChats(const std::string& username) {
                 ELSE sender 
             END as chat_partner,
             'direct' as type,
-            content as last_message,
+            COALESCE((SELECT b.content FROM message_bodies b WHERE b.hash = messages.body_hash),
+                     content) as last_message,
             timestamp as last_message_time,
             (SELECT COUNT(*) FROM messages m2 
              WHERE ((m2.sender = messages.sender AND m2.receiver = messages.receiver) OR 
@@ -415,7 +762,10 @@ std::vector<Chat> Database::getUserChats(const std::string& username) {
                         AND m2.sender != ?), 0) as unread_count
         FROM chatroom_members cm
         LEFT JOIN (
-            SELECT receiver, content, timestamp,
+            SELECT receiver,
+                   COALESCE((SELECT b.content FROM message_bodies b WHERE b.hash = messages.body_hash),
+                            content) as content,
+                   timestamp,
                    ROW_NUMBER() OVER (PARTITION BY receiver ORDER BY timestamp DESC) as rn
             FROM messages 
             WHERE receiver IN (SELECT chatroom_name FROM chatroom_members WHERE username = ?)
@@ -445,4 +795,87 @@ std::vector<Chat> Database::getUserChats(const std::string& username) {
     sqlite3_finalize(stmt);
     
     return chats;
-}
\ No newline at end of file
+}
+
+// ================== Reminders ==================
+bool Database::saveReminder(const StoredReminder& reminder) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db) return false;
+    
+    const char* sql = "INSERT OR REPLACE INTO reminders (id, username, title, due_at) VALUES (?, ?, ?, ?)";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return false;
+    
+    sqlite3_bind_text(stmt, 1, reminder.id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, reminder.username.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, reminder.title.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 4, reminder.dueAtMs);
+    
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+bool Database::deleteReminder(const std::string& reminderId) {
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db) return false;
+    
+    const char* sql = "DELETE FROM reminders WHERE id = ?";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return false;
+    
+    sqlite3_bind_text(stmt, 1, reminderId.c_str(), -1, SQLITE_STATIC);
+    
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
+}
+
+std::vector<StoredReminder> Database::loadReminders() {
+    std::vector<StoredReminder> reminders;
+    sqlite3* db = static_cast<sqlite3*>(dbConnection);
+    if (!db) return reminders;
+    
+    const char* sql = "SELECT id, username, title, due_at FROM reminders ORDER BY due_at ASC";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) return reminders;
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        StoredReminder reminder;
+        reminder.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        reminder.username = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        reminder.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        reminder.dueAtMs = sqlite3_column_int64(stmt, 3);
+        reminders.push_back(reminder);
+    }
+    
+    sqlite3_finalize(stmt);
+    return reminders;
+}
+
+// ================== Change Notifications ==================
+int Database::subscribe(ChangeListener listener) {
+    int subscriptionId = nextSubscriptionId++;
+    listeners.emplace(subscriptionId, std::move(listener));
+    return subscriptionId;
+}
+
+void Database::unsubscribe(int subscriptionId) {
+    listeners.erase(subscriptionId);
+}
+
+void Database::publish(const ChangeEvent& event) {
+    if (listeners.empty()) return;
+
+    // Copy first so a listener may subscribe/unsubscribe while being notified
+    auto snapshot = listeners;
+    for (const auto& [subscriptionId, listener] : snapshot) {
+        if (listener) listener(event);
+    }
+}
@@ -4,6 +4,9 @@
 #include <vector>
 #include <utility> // for std::pair
 #include <optional>
+#include <functional>
+#include <map>
+#include "DedupWindow.h"
 
 // Represents a single message
 struct Message {
@@ -14,6 +17,8 @@ struct Message {
     std::string timestamp;
     bool isRead;
     bool isEdited;
+    int forwardedFrom = -1;     // Id of the original message for forwards
+    std::string forwardOrigin;  // Where the forward came from (room or user), empty otherwise
 };
 
 // Represents a chat (either direct message or chatroom)
@@ -26,6 +31,42 @@ struct Chat {
     bool isActive;          // Whether chat is still active/accessible
 };
 
+// Kind of change published by the write path
+enum class ChangeType {
+    MessageInserted,
+    MessageEdited,
+    MessageRead,
+    MemberAdded
+};
+
+// A committed change, delivered to subscribers after the write succeeds
+struct ChangeEvent {
+    ChangeType type;
+    int messageId;           // Row id of the affected message (-1 for membership changes)
+    std::string sender;      // Sender of the message, or the added member
+    std::string receiver;    // Username or chatroom name the change belongs to
+    std::string content;     // New content for inserts/edits, empty otherwise
+};
+
+using ChangeListener = std::function<void(const ChangeEvent&)>;
+
+// A scheduled reminder; dueAtMs is milliseconds since the Unix epoch
+struct StoredReminder {
+    std::string id;
+    std::string username;
+    std::string title;
+    long long dueAtMs = 0;
+};
+
+// Receipts for one conversation: every message from sender to receiver with an id up to
+// the watermark is delivered (or seen). 0 means no watermark of that kind.
+struct ReceiptWatermark {
+    std::string sender;
+    std::string receiver;
+    int deliveredUpTo = 0;
+    int seenUpTo = 0;
+};
+
 class Database {
 public:
     Database(const std::string& dbPath); // Constructor (open/init DB)
@@ -38,11 +79,27 @@ public:
     // Chatroom management
     bool createChatroom(const std::string& chatroomName);
     bool addUserToChatroom(const std::string& username, const std::string& chatroomName);
+    // Adds all users in one transaction; result[i] tells whether usernames[i] was added
+    std::vector<bool> addUsersToChatroom(const std::vector<std::string>& usernames, const std::string& chatroomName);
     
     // Message handling
     bool sendMessage(const std::string& sender, const std::string& receiver, const std::string& content);
+    // Idempotent insert keyed by a client-generated message key, unique per sender: a repeated
+    // call stores nothing and returns the row id of the first one. -1 on failure. Keys seen in
+    // the last few minutes are answered from memory without touching SQLite.
+    int storeMessageOnce(const std::string& clientId, const std::string& sender,
+                         const std::string& receiver, const std::string& content);
+    // Row id stored under a sender's client message key, -1 if there is none
+    int findMessageByClientId(const std::string& sender, const std::string& clientId);
     bool editMessage(int messageId, const std::string& newContent);
     bool markMessageAsRead(int messageId);
+    // Applies all watermarks in one transaction; returns the number of messages changed, -1 on failure.
+    // Seen implies delivered and read; a MessageRead event is published for every newly read message.
+    int applyReceiptWatermarks(const std::vector<ReceiptWatermark>& watermarks);
+    // Stores the body once in message_bodies (keyed by content hash) and references it.
+    // A non-empty clientId is recorded like storeMessageOnce's, for findMessageByClientId.
+    bool forwardMessage(const std::string& sender, const std::string& receiver, const std::string& content,
+                        int originalMessageId, const std::string& origin, const std::string& clientId = "");
     
     // Message queries
     std::vector<Message> getMessageHistory(const std::string& user1, const std::string& user2);
@@ -52,14 +109,30 @@ public:
     
     // Chat overview
     std::vector<Chat> getUserChats(const std::string& username);
+
+    // Reminders (rows live until the reminder is delivered or cancelled)
+    bool saveReminder(const StoredReminder& reminder);     // Inserts or replaces by id
+    bool deleteReminder(const std::string& reminderId);
+    std::vector<StoredReminder> loadReminders();            // Ordered by due time
+
+    // Change notifications
+    // Listeners run synchronously on the writing thread, right after the statement commits.
+    int subscribe(ChangeListener listener);  // Returns a subscription id
+    void unsubscribe(int subscriptionId);
     
 private:
     void connect(const std::string& dbPath);
     void disconnect();
     // Optional: internal helpers for query execution
     void initializeSchema(); // Called during construction to ensure DB schema exists
+    void addColumnIfMissing(const std::string& table, const std::string& column, const std::string& type);
     // Your DB connection object (placeholder, replace with actual DB object, e.g. SQLite3* db)
     void* dbConnection;
+
+    void publish(const ChangeEvent& event);
+    std::map<int, ChangeListener> listeners;
+    DedupWindow recentClientIds;    // sender + client key -> row id
+    int nextSubscriptionId = 1;
 };
 
 #endif // DATABASE_H
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "DedupWindow.h"
+#include <algorithm>
+
+DedupWindow::DedupWindow(std::chrono::seconds window, size_t maxKeys)
+    // One extra bucket, so a key stays for at least the full window
+    : wheel(static_cast<size_t>(std::max<int64_t>(window.count(), 1)) + 1),
+      maxKeys(std::max<size_t>(maxKeys, 1)),
+      currentSecond(nowSecond()) {}
+
+int64_t DedupWindow::nowSecond() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::optional<int> DedupWindow::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(nowSecond());
+    auto it = known.find(key);
+    if (it == known.end()) {
+        counters.misses++;
+        return std::nullopt;
+    }
+    counters.hits++;
+    return it->second;
+}
+
+void DedupWindow::remember(const std::string& key, int messageId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(nowSecond());
+    if (known.count(key)) {
+        return;
+    }
+
+    // Full: drop the oldest buckets first
+    size_t size = wheel.size();
+    for (size_t step = 1; known.size() >= maxKeys && step < size; step++) {
+        expireBucket(static_cast<size_t>(currentSecond + static_cast<int64_t>(step)) % size);
+    }
+    if (known.size() >= maxKeys) {
+        return;     // Everything is from this very second; the database still deduplicates
+    }
+
+    known.emplace(key, messageId);
+    wheel[static_cast<size_t>(currentSecond) % size].push_back(key);
+}
+
+DedupWindow::Stats DedupWindow::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = counters;
+    result.size = known.size();
+    return result;
+}
+
+void DedupWindow::advance(int64_t second) {
+    if (second <= currentSecond) {
+        return;
+    }
+    // Every bucket the clock passes over now belongs to a second that has left the window
+    int64_t steps = std::min<int64_t>(second - currentSecond, static_cast<int64_t>(wheel.size()));
+    for (int64_t step = 1; step <= steps; step++) {
+        expireBucket(static_cast<size_t>(second - steps + step) % wheel.size());
+    }
+    currentSecond = second;
+}
+
+void DedupWindow::expireBucket(size_t index) {
+    for (const std::string& key : wheel[index]) {
+        if (known.erase(key)) {
+            counters.expired++;
+        }
+    }
+    wheel[index].clear();
+}
@@ -0,0 +1,48 @@
+#ifndef DEDUPWINDOW_H
+#define DEDUPWINDOW_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+
+// Remembers the message id stored for each recently seen client message key, so a
+// retried send is answered from memory instead of another round trip to SQLite.
+// Keys live in a hash map and, for expiry, in a time wheel of one-second buckets:
+// moving the clock forward clears whole buckets instead of scanning every key.
+// Forgetting a key is always safe, since the unique index remains the real guard.
+// Thread-safe.
+class DedupWindow {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t expired = 0;   // Aged out of the window or evicted at maxKeys
+        size_t size = 0;
+    };
+
+    explicit DedupWindow(std::chrono::seconds window = std::chrono::seconds(300), size_t maxKeys = 1 << 20);
+
+    // Message id stored for key, if it was seen within the window
+    std::optional<int> find(const std::string& key);
+    // A key that is already known keeps its first id and expiry
+    void remember(const std::string& key, int messageId);
+    Stats stats() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, int> known;    // Key -> message id
+    std::vector<std::vector<std::string>> wheel;   // Bucket i holds keys remembered at a second = i (mod size)
+    size_t maxKeys;
+    int64_t currentSecond;
+    Stats counters;
+
+    static int64_t nowSecond();
+    void advance(int64_t second);       // Call with mutex held
+    void expireBucket(size_t index);    // Call with mutex held
+};
+
+#endif // DEDUPWINDOW_H
@@ -0,0 +1,207 @@
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void consoleSink(LogLevel level, std::string_view line) {
+    std::FILE* out = level >= LogLevel::Warn ? stderr : stdout;
+    std::fwrite(line.data(), 1, line.size(), out);
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : slots(new Slot[CAPACITY]), sink(consoleSink) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger() {
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void Logger::setRateLimit(int recordsPerSecondPerSite) {
+    rateLimit.store(recordsPerSecondPerSite > 0 ? recordsPerSecondPerSite : 0, std::memory_order_relaxed);
+}
+
+void Logger::setSink(Sink newSink) {
+    flush();
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sink = newSink ? std::move(newSink) : Sink(consoleSink);
+}
+
+// ================== Producers ==================
+bool Logger::admit(LogSite& site, int& suppressedBefore) {
+    suppressedBefore = 0;
+    int limit = rateLimit.load(std::memory_order_relaxed);
+    if (limit == 0) {
+        return true;
+    }
+
+    int64_t second = nowMs() / 1000;
+    int64_t window = site.windowSecond.load(std::memory_order_relaxed);
+    if (window != second && site.windowSecond.compare_exchange_strong(window, second)) {
+        site.countInWindow.store(0, std::memory_order_relaxed);
+    }
+    if (site.countInWindow.fetch_add(1, std::memory_order_relaxed) >= limit) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        suppressedTotal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressedBefore = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::log(LogSite& site, std::string_view text) {
+    int suppressedBefore;
+    if (!admit(site, suppressedBefore)) {
+        return;
+    }
+    std::call_once(startOnce, [this] { worker = std::thread(&Logger::run, this); });
+
+    // Bounded MPMC ring (Vyukov): claim a position whose slot the consumer has released
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & (CAPACITY - 1)];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);   // Full: never block the caller
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t length = std::min(text.size(), TEXT_CAPACITY);
+    while (length < text.size() && length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+        length--;   // Do not cut a UTF-8 sequence in half
+    }
+    slot->level = site.level;
+    slot->event = site.event;
+    slot->timeMs = nowMs();
+    slot->suppressed = suppressedBefore;
+    slot->length = static_cast<uint16_t>(length);
+    std::memcpy(slot->text, text.data(), length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (sleeping.load()) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+}
+
+void Logger::flush() {
+    uint64_t target = enqueuePos.load();
+    while (consumed.load() < target && worker.joinable() && !stopping.load()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wake.notify_one();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+Logger::Stats Logger::stats() const {
+    return {written.load(), dropped.load(), suppressedTotal.load()};
+}
+
+// ================== Logger Thread ==================
+std::string Logger::formatLine(const Slot& slot) {
+    static const char* const names[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+    std::time_t seconds = static_cast<std::time_t>(slot.timeMs / 1000);
+    std::tm tm;
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char stamp[32];
+    size_t stampLength = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+
+    std::string line;
+    line.reserve(64 + slot.length);
+    line.append(stamp, stampLength);
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ".%03d ", static_cast<int>(slot.timeMs % 1000));
+    line += millis;
+    line += names[static_cast<int>(slot.level)];
+    line += ' ';
+    line += slot.event;
+    line += ' ';
+    line.append(slot.text, slot.length);
+    if (slot.suppressed > 0) {
+        line += " (" + std::to_string(slot.suppressed) + " similar suppressed)";
+    }
+    line += '\n';
+    return line;
+}
+
+size_t Logger::drain() {
+    size_t count = 0;
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    while (true) {
+        Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;
+        }
+        LogLevel level = slot.level;
+        std::string line = formatLine(slot);
+        slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+        dequeuePos++;
+
+        sink(level, line);
+        count++;
+    }
+    if (count > 0) {
+        // One flush per batch, not per line
+        std::fflush(stdout);
+        std::fflush(stderr);
+        written.fetch_add(count, std::memory_order_relaxed);
+        consumed.store(dequeuePos);
+    }
+    return count;
+}
+
+void Logger::run() {
+    while (true) {
+        if (drain() > 0) {
+            continue;
+        }
+        if (stopping.load()) {
+            drain();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        sleeping.store(true);
+        // Re-check after announcing the sleep, so a record logged meanwhile is not missed
+        const Slot& next = slots[dequeuePos & (CAPACITY - 1)];
+        if (next.sequence.load(std::memory_order_acquire) != dequeuePos + 1 && !stopping.load()) {
+            wake.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        sleeping.store(false);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include <cstdint>
+
+enum class LogLevel : uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3,
+    Off = 4
+};
+
+// Levels below this are compiled out entirely, arguments included (-DLOG_MIN_LEVEL=2 keeps Warn and up)
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 1
+#endif
+
+// One LOG_* call site: its event name and its rate-limit window
+struct LogSite {
+    const char* event;
+    LogLevel level;
+    std::atomic<int64_t> windowSecond{-1};
+    std::atomic<int> countInWindow{0};
+    std::atomic<int> suppressed{0};     // Dropped by the limit since the last record that got through
+
+    LogSite(const char* event, LogLevel level) : event(event), level(level) {}
+};
+
+// Asynchronous logger. log() formats nothing and never blocks: it copies the text into
+// a fixed slot of a bounded lock-free ring (multi-producer, single consumer) and returns.
+// A background thread turns slots into lines and hands them to the sink, flushing once
+// per drained batch instead of once per line. If the ring is full the record is dropped
+// and counted. Each call site is also rate limited (records per second), with the number
+// of suppressed records reported on the next one that passes.
+class Logger {
+public:
+    // Receives complete lines (UTF-8, newline included), on the logger thread only
+    using Sink = std::function<void(LogLevel level, std::string_view line)>;
+
+    struct Stats {
+        uint64_t written = 0;
+        uint64_t dropped = 0;       // Ring full
+        uint64_t suppressed = 0;    // Rate limited
+    };
+
+    static Logger& instance();
+    ~Logger();      // Writes what is still queued
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+    void setRateLimit(int recordsPerSecondPerSite);     // 0 = unlimited
+    void setSink(Sink sink);                            // Default: Info and below to stdout, the rest to stderr
+
+    void log(LogSite& site, std::string_view text);
+    void flush();   // Blocks until everything logged so far has reached the sink
+    Stats stats() const;
+
+    static constexpr size_t TEXT_CAPACITY = 240;    // Longer texts are cut (on a UTF-8 boundary)
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        LogLevel level;
+        const char* event;
+        int64_t timeMs;
+        int suppressed;
+        uint16_t length;
+        char text[TEXT_CAPACITY];
+    };
+
+    static constexpr size_t CAPACITY = 4096;    // Power of two
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> enqueuePos{0};
+    uint64_t dequeuePos = 0;                // Logger thread only
+    std::atomic<uint64_t> consumed{0};
+
+    std::atomic<LogLevel> minLevel{LogLevel::Info};
+    std::atomic<int> rateLimit{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> suppressedTotal{0};
+
+    std::mutex sinkMutex;
+    Sink sink;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::once_flag startOnce;
+    std::thread worker;
+
+    Logger();
+    bool admit(LogSite& site, int& suppressedBefore);
+    void run();
+    size_t drain();
+    static std::string formatLine(const Slot& slot);
+};
+
+#define LOG_AT(levelValue, eventName, text)                                                   \
+    do {                                                                                      \
+        if constexpr (static_cast<int>(levelValue) >= LOG_MIN_LEVEL) {                        \
+            static LogSite logSite(eventName, levelValue);                                    \
+            Logger& logger = Logger::instance();                                              \
+            if (logger.enabled(levelValue)) {                                                 \
+                logger.log(logSite, text);                                                    \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+// The text expression is only evaluated when the level is enabled
+#define LOG_DEBUG(event, text) LOG_AT(LogLevel::Debug, event, text)
+#define LOG_INFO(event, text) LOG_AT(LogLevel::Info, event, text)
+#define LOG_WARN(event, text) LOG_AT(LogLevel::Warn, event, text)
+#define LOG_ERROR(event, text) LOG_AT(LogLevel::Error, event, text)
+
+#endif // LOGGER_H
@@ -0,0 +1,131 @@
+#include "RateLimiter.h"
+#include <algorithm>
+#include <cmath>
+
+// A limited bucket must hold at least one token, or nothing would ever pass
+static RateLimiterConfig normalized(RateLimiterConfig config) {
+    for (RateLimit* limit : {&config.perUser, &config.perRoom, &config.global}) {
+        if (limit->ratePerSecond > 0) {
+            limit->burst = std::max(limit->burst, 1.0);
+        }
+    }
+    return config;
+}
+
+RateLimiter::RateLimiter(RateLimiterConfig config) : config(normalized(config)) {
+    globalBucket = {this->config.global.burst, Clock::now()};
+}
+
+void RateLimiter::setConfig(const RateLimiterConfig& newConfig) {
+    std::lock_guard<std::mutex> lock(mutex);
+    config = normalized(newConfig);
+    userBuckets.clear();
+    roomBuckets.clear();
+    globalBucket = {config.global.burst, Clock::now()};
+}
+
+RateLimiterStats RateLimiter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+// ================== Buckets ==================
+void RateLimiter::refill(Bucket& bucket, const RateLimit& limit, Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - bucket.updatedAt).count();
+    bucket.tokens = std::min(limit.burst, bucket.tokens + elapsed * limit.ratePerSecond);
+    bucket.updatedAt = now;
+}
+
+std::chrono::milliseconds RateLimiter::waitFor(const Bucket& bucket, const RateLimit& limit) {
+    double missing = 1.0 - bucket.tokens;
+    return std::chrono::milliseconds(static_cast<long long>(std::ceil(missing / limit.ratePerSecond * 1000.0)));
+}
+
+RateLimiter::Bucket& RateLimiter::bucketFor(std::unordered_map<std::string, Bucket>& buckets,
+                                            const std::string& key, const RateLimit& limit,
+                                            Clock::time_point now) {
+    auto it = buckets.find(key);
+    if (it == buckets.end()) {
+        it = buckets.emplace(key, Bucket{limit.burst, now}).first;
+    } else {
+        refill(it->second, limit, now);
+    }
+    return it->second;
+}
+
+void RateLimiter::sweepIdle(Clock::time_point now) {
+    // A bucket that has refilled completely carries no state; drop it to bound memory
+    auto sweep = [now](std::unordered_map<std::string, Bucket>& buckets, const RateLimit& limit) {
+        for (auto it = buckets.begin(); it != buckets.end();) {
+            refill(it->second, limit, now);
+            if (it->second.tokens >= limit.burst) {
+                it = buckets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    };
+    sweep(userBuckets, config.perUser);
+    sweep(roomBuckets, config.perRoom);
+}
+
+// ================== Admission ==================
+AdmissionDecision RateLimiter::tryAcquire(const std::string& userKey, const std::string& roomKey) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Clock::time_point now = Clock::now();
+
+    if (++callsSinceSweep >= 4096) {
+        callsSinceSweep = 0;
+        sweepIdle(now);
+    }
+
+    bool limitUser = config.perUser.ratePerSecond > 0;
+    bool limitRoom = config.perRoom.ratePerSecond > 0;
+    bool limitGlobal = config.global.ratePerSecond > 0;
+
+    Bucket* user = limitUser ? &bucketFor(userBuckets, userKey, config.perUser, now) : nullptr;
+    Bucket* room = limitRoom ? &bucketFor(roomBuckets, roomKey, config.perRoom, now) : nullptr;
+    if (limitGlobal) {
+        refill(globalBucket, config.global, now);
+    }
+
+    // Check everything first so a rejection consumes nothing
+    AdmissionDecision decision;
+    if (user && user->tokens < 1.0) {
+        decision.allowed = false;
+        decision.rejectedBy = AdmissionScope::USER;
+        decision.retryAfter = waitFor(*user, config.perUser);
+    }
+    if (room && room->tokens < 1.0) {
+        auto wait = waitFor(*room, config.perRoom);
+        if (decision.allowed || wait > decision.retryAfter) {
+            decision.rejectedBy = AdmissionScope::ROOM;
+            decision.retryAfter = wait;
+        }
+        decision.allowed = false;
+    }
+    if (limitGlobal && globalBucket.tokens < 1.0) {
+        auto wait = waitFor(globalBucket, config.global);
+        if (decision.allowed || wait > decision.retryAfter) {
+            decision.rejectedBy = AdmissionScope::GLOBAL;
+            decision.retryAfter = wait;
+        }
+        decision.allowed = false;
+    }
+
+    if (!decision.allowed) {
+        switch (decision.rejectedBy) {
+            case AdmissionScope::USER: stats.shedByUser++; break;
+            case AdmissionScope::ROOM: stats.shedByRoom++; break;
+            case AdmissionScope::GLOBAL: stats.shedGlobal++; break;
+            case AdmissionScope::NONE: break;
+        }
+        return decision;
+    }
+
+    if (user) user->tokens -= 1.0;
+    if (room) room->tokens -= 1.0;
+    if (limitGlobal) globalBucket.tokens -= 1.0;
+    stats.admitted++;
+    return decision;
+}
@@ -0,0 +1,79 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <string>
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+
+// Token-bucket limit; ratePerSecond <= 0 means unlimited
+struct RateLimit {
+    double ratePerSecond = 0;   // Sustained requests per second
+    double burst = 0;           // Bucket capacity (requests allowed back to back)
+};
+
+struct RateLimiterConfig {
+    RateLimit perUser;          // Each sender, across all rooms
+    RateLimit perRoom;          // Each room / conversation
+    RateLimit global;           // Everything that reaches the database writer
+};
+
+enum class AdmissionScope {
+    NONE,                       // Admitted
+    USER,                       // Rejected by the sender's bucket
+    ROOM,                       // Rejected by the room's bucket
+    GLOBAL                      // Rejected by the global bucket
+};
+
+struct AdmissionDecision {
+    bool allowed = true;
+    AdmissionScope rejectedBy = AdmissionScope::NONE;
+    std::chrono::milliseconds retryAfter{0};  // When a retry can succeed (0 if allowed)
+};
+
+struct RateLimiterStats {
+    uint64_t admitted = 0;
+    uint64_t shedByUser = 0;
+    uint64_t shedByRoom = 0;
+    uint64_t shedGlobal = 0;
+
+    uint64_t shed() const { return shedByUser + shedByRoom + shedGlobal; }
+};
+
+// Admission control in front of the single SQLite writer.
+// A request is admitted only if the user, room and global buckets all have a token;
+// otherwise nothing is consumed and the caller gets a retry-after hint.
+class RateLimiter {
+public:
+    explicit RateLimiter(RateLimiterConfig config = {});
+
+    AdmissionDecision tryAcquire(const std::string& userKey, const std::string& roomKey);
+
+    void setConfig(const RateLimiterConfig& config);
+    RateLimiterStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Bucket {
+        double tokens;
+        Clock::time_point updatedAt;
+    };
+
+    RateLimiterConfig config;
+    std::unordered_map<std::string, Bucket> userBuckets;
+    std::unordered_map<std::string, Bucket> roomBuckets;
+    Bucket globalBucket;
+    RateLimiterStats stats;
+    uint64_t callsSinceSweep = 0;
+    mutable std::mutex mutex;
+
+    static void refill(Bucket& bucket, const RateLimit& limit, Clock::time_point now);
+    static std::chrono::milliseconds waitFor(const Bucket& bucket, const RateLimit& limit);
+    Bucket& bucketFor(std::unordered_map<std::string, Bucket>& buckets, const std::string& key,
+                      const RateLimit& limit, Clock::time_point now);
+    void sweepIdle(Clock::time_point now);
+};
+
+#endif // RATELIMITER_H
@@ -0,0 +1,478 @@
+#include "MessageCache.h"
+#include "TextSearch.h"
+#include <algorithm>
+#include <mutex>
+
+MessageCache::MessageCache(size_t shard_count) {
+    shard_count = std::max<size_t>(shard_count, 1);
+    shards.reserve(shard_count);
+    directory.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        shards.push_back(std::make_unique<Shard>());
+        directory.push_back(std::make_unique<DirectoryShard>());
+        recent_by_user.push_back(std::make_unique<RecentShard>());
+    }
+}
+
+size_t MessageCache::shard_index(const std::wstring& key) const {
+    return std::hash<std::wstring>()(key) % shards.size();
+}
+
+// Content, sender and receiver folded once, NUL-separated so a match cannot span two fields
+std::string MessageCache::search_text(const ChatMessage& msg) {
+    return fold_for_search(msg.content + L'\0' + msg.sender + L'\0' + msg.receiver);
+}
+
+void MessageCache::Shard::set_search_text(size_t slot, const std::string& text, bool searchable) {
+    if (slot == search_spans.size()) {
+        search_spans.push_back({search_arena.size(), static_cast<uint32_t>(text.size()), searchable});
+        search_arena += text;
+        return;
+    }
+
+    // Edits append the new text; compact once more than half of the arena is stale
+    search_garbage += search_spans[slot].length;
+    search_spans[slot] = {search_arena.size(), static_cast<uint32_t>(text.size()), searchable};
+    search_arena += text;
+
+    if (search_garbage > search_arena.size() / 2) {
+        std::string compacted;
+        compacted.reserve(search_arena.size() - search_garbage);
+        for (SearchSpan& span : search_spans) {
+            size_t offset = compacted.size();
+            compacted.append(search_arena, span.offset, span.length);
+            span.offset = offset;
+        }
+        search_arena.swap(compacted);
+        search_garbage = 0;
+    }
+}
+
+MessageCache::Shard* MessageCache::shard_holding(const std::wstring& id, uint32_t* index) const {
+    const DirectoryShard& entry = *directory[shard_index(id)];
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
+    auto it = entry.shard_of.find(id);
+    if (it == entry.shard_of.end()) {
+        return nullptr;
+    }
+    if (index) {
+        *index = it->second;
+    }
+    return shards[it->second].get();
+}
+
+bool MessageCache::add(const ChatMessage& msg) {
+    size_t target = shard_index(msg.receiver);
+    {
+        // Claim the id first; a racing add of the same id loses here
+        DirectoryShard& entry = *directory[shard_index(msg.id)];
+        std::unique_lock<std::shared_mutex> lock(entry.mutex);
+        if (!entry.shard_of.emplace(msg.id, static_cast<uint32_t>(target)).second) {
+            return false;
+        }
+    }
+
+    std::string text = search_text(msg);
+    Shard& shard = *shards[target];
+    UnreadChange change;
+    MessageRef ref{static_cast<uint32_t>(target), 0};
+    {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.store.add(msg);
+        shard.sequence.push_back(next_sequence++);
+        ref.slot = shard.sequence.size() - 1;
+        shard.set_search_text(ref.slot, text, !msg.is_deleted);
+        if (counts_as_unread(msg)) {
+            change = shard.adjust_unread(msg.receiver, msg.sender, +1);
+        }
+    }
+
+    if (!is_removed(msg)) {
+        remember_recent(msg.sender, ref);
+        if (msg.receiver != msg.sender) {
+            remember_recent(msg.receiver, ref);
+        }
+        std::lock_guard<std::mutex> lock(recent_all_mutex);
+        recent_all.push(ref);
+    }
+    publish_unread(change);
+    return true;
+}
+
+bool MessageCache::get(const std::wstring& id, ChatMessage& out) const {
+    Shard* shard = shard_holding(id);
+    if (!shard) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(shard->mutex);
+    // False if claimed by a concurrent add that has not landed yet
+    return shard->store.get(id, out);
+}
+
+bool MessageCache::update(const std::wstring& id, const std::function<bool(ChatMessage&)>& fn) {
+    MessageRef ref{0, 0};
+    Shard* shard = shard_holding(id, &ref.shard);
+    if (!shard) {
+        return false;
+    }
+    UnreadChange change;
+    bool removed_now = false;
+    std::wstring sender, receiver;
+    {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        if (!shard->store.slot_of(id, ref.slot)) {
+            return false;
+        }
+        // The store keeps a compact record: edit a materialized copy and write it back
+        ChatMessage msg = shard->store.at(ref.slot);
+        bool was_unread = counts_as_unread(msg);
+        bool was_removed = is_removed(msg);
+        if (!fn(msg)) {
+            return false;
+        }
+        shard->store.replace(ref.slot, msg);
+        shard->set_search_text(ref.slot, search_text(msg), !msg.is_deleted);
+
+        bool is_unread = counts_as_unread(msg);
+        if (was_unread != is_unread) {
+            change = shard->adjust_unread(msg.receiver, msg.sender, is_unread ? +1 : -1);
+        }
+        if (!was_removed && is_removed(msg)) {
+            removed_now = true;
+            sender = msg.sender;
+            receiver = msg.receiver;
+        }
+    }
+
+    // Deleted by both sides: drop it from the recent rings
+    if (removed_now) {
+        forget_recent(sender, ref);
+        forget_recent(receiver, ref);
+        std::lock_guard<std::mutex> lock(recent_all_mutex);
+        recent_all.erase(ref);
+    }
+    publish_unread(change);
+    return true;
+}
+
+bool MessageCache::mark_up_to(const std::wstring& id, Receipt receipt, time_t when,
+                              std::wstring& sender, std::wstring& receiver) {
+    Shard* shard = shard_holding(id);
+    if (!shard) {
+        return false;
+    }
+    const uint16_t mark = receipt == Receipt::Seen ? MessageStore::FLAG_SEEN : MessageStore::FLAG_DELIVERED;
+    UnreadChange change;
+    {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        MessageStore& store = shard->store;
+        size_t target;
+        if (!store.slot_of(id, target) || (store.flags(target) & MessageStore::FLAG_DELETED)) {
+            return false;
+        }
+        sender = store.sender_at(target);
+        receiver = store.receiver_at(target);
+
+        // The receiver's slots are ascending: walk back from the target through the conversation
+        const std::vector<size_t>& received = store.received_by(receiver);
+        size_t i = static_cast<size_t>(std::lower_bound(received.begin(), received.end(), target) - received.begin()) + 1;
+        int newly_read = 0;
+        while (i-- > 0) {
+            size_t slot = received[i];
+            if (store.sender_at(slot) != sender) {
+                continue;
+            }
+            uint16_t flags = store.flags(slot);
+            if (flags & mark) {
+                if (slot == target) {
+                    continue;
+                }
+                break;
+            }
+            if (flags & MessageStore::FLAG_DELETED) {
+                continue;
+            }
+            if (receipt == Receipt::Seen) {
+                const uint16_t not_unread = MessageStore::FLAG_READ | MessageStore::FLAG_DELETED_BY_RECEIVER;
+                newly_read += (flags & not_unread) == 0;
+                store.mark_seen(slot, when);
+            } else {
+                store.mark_delivered(slot, when);
+            }
+        }
+        if (newly_read > 0) {
+            change = shard->adjust_unread(receiver, sender, -newly_read);
+        }
+    }
+    publish_unread(change);
+    return true;
+}
+
+void MessageCache::for_each_received(const std::wstring& user,
+                                     const std::function<void(const ChatMessage&)>& fn) const {
+    const Shard& shard = *shards[shard_index(user)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    for (size_t slot : shard.store.received_by(user)) {
+        fn(shard.store.at(slot));
+    }
+}
+
+// Visits the union of two ascending slot lists; a message to oneself is in both
+template <typename Visit>
+static void merge_slots(const std::vector<size_t>& a, const std::vector<size_t>& b, Visit visit) {
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() || (i < a.size() && a[i] < b[j])) {
+            visit(a[i++]);
+        } else if (i == a.size() || b[j] < a[i]) {
+            visit(b[j++]);
+        } else {
+            visit(a[i]);
+            i++;
+            j++;
+        }
+    }
+}
+
+void MessageCache::for_each_involving(const std::wstring& user,
+                                      const std::function<void(const ChatMessage&)>& fn) const {
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        merge_slots(shard->store.sent_by(user), shard->store.received_by(user),
+                    [&](size_t slot) { fn(shard->store.at(slot)); });
+    }
+}
+
+std::vector<ChatMessage> MessageCache::latest_involving(const std::wstring& user, size_t limit,
+                                                        const std::function<bool(const ChatMessage&)>& keep) const {
+    // Each shard contributes at most `limit` candidates, newest first; then merge by sequence
+    std::vector<std::pair<uint64_t, ChatMessage>> candidates;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        const std::vector<size_t>& sent = shard->store.sent_by(user);
+        const std::vector<size_t>& received = shard->store.received_by(user);
+
+        size_t i = sent.size(), j = received.size(), taken = 0;
+        while ((i > 0 || j > 0) && taken < limit) {
+            size_t slot;
+            if (j == 0 || (i > 0 && sent[i - 1] > received[j - 1])) {
+                slot = sent[--i];
+            } else if (i == 0 || received[j - 1] > sent[i - 1]) {
+                slot = received[--j];
+            } else {
+                slot = sent[--i];
+                --j;
+            }
+
+            ChatMessage msg = shard->store.at(slot);
+            if (keep(msg)) {
+                candidates.emplace_back(shard->sequence[slot], std::move(msg));
+                taken++;
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+    candidates.resize(std::min(limit, candidates.size()));
+
+    std::vector<ChatMessage> result;
+    result.reserve(candidates.size());
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+        result.push_back(std::move(it->second));
+    }
+    return result;
+}
+
+size_t MessageCache::search_involving(const std::wstring& user, const std::wstring& keyword,
+                                      std::vector<std::wstring>& ids, size_t offset, size_t limit) const {
+    ids.clear();
+    std::string needle = fold_for_search(keyword);
+    if (needle.find('\0') != std::string::npos) {
+        return 0;
+    }
+
+    // (sequence, shard, slot) of every match; ids are copied only for the requested page
+    struct Match {
+        uint64_t sequence;
+        size_t shard;
+        size_t slot;
+    };
+    std::vector<Match> matches;
+
+    for (size_t s = 0; s < shards.size(); s++) {
+        const Shard& shard = *shards[s];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        const char* arena = shard.search_arena.data();
+        merge_slots(shard.store.sent_by(user), shard.store.received_by(user), [&](size_t slot) {
+            const SearchSpan& span = shard.search_spans[slot];
+            if (span.searchable && contains_folded(arena + span.offset, span.length, needle.data(), needle.size())) {
+                matches.push_back({shard.sequence[slot], s, slot});
+            }
+        });
+    }
+
+    std::sort(matches.begin(), matches.end(),
+              [](const Match& a, const Match& b) { return a.sequence < b.sequence; });
+
+    for (size_t i = offset; i < matches.size() && ids.size() < limit; i++) {
+        const Shard& shard = *shards[matches[i].shard];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        ids.push_back(shard.store.id_at(matches[i].slot));
+    }
+    return matches.size();
+}
+
+// ================== Recent Messages ==================
+bool MessageCache::is_removed(const ChatMessage& msg) {
+    return msg.deleted_by_sender && msg.deleted_by_receiver;
+}
+
+void MessageCache::remember_recent(const std::wstring& user, const MessageRef& ref) {
+    RecentShard& recent_shard = *recent_by_user[shard_index(user)];
+    std::lock_guard<std::mutex> lock(recent_shard.mutex);
+    UserRecent& recent = recent_shard.users[user];
+    if (recent.ring.push(ref)) {
+        recent.complete = false;
+    }
+}
+
+void MessageCache::forget_recent(const std::wstring& user, const MessageRef& ref) {
+    RecentShard& recent_shard = *recent_by_user[shard_index(user)];
+    std::lock_guard<std::mutex> lock(recent_shard.mutex);
+    auto it = recent_shard.users.find(user);
+    if (it != recent_shard.users.end()) {
+        it->second.ring.erase(ref);
+    }
+}
+
+// Copies the referenced messages (newest first in refs) that are still live; result is oldest first
+std::vector<ChatMessage> MessageCache::resolve_live(const std::vector<MessageRef>& refs, size_t limit) const {
+    std::vector<ChatMessage> result;
+    result.reserve(std::min(limit, refs.size()));
+    for (const MessageRef& ref : refs) {
+        if (result.size() == limit) {
+            break;
+        }
+        const Shard& shard = *shards[ref.shard];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        const uint16_t removed = MessageStore::FLAG_DELETED_BY_SENDER | MessageStore::FLAG_DELETED_BY_RECEIVER;
+        if ((shard.store.flags(ref.slot) & removed) != removed) {
+            result.push_back(shard.store.at(ref.slot));
+        }
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+std::vector<ChatMessage> MessageCache::recent_involving(const std::wstring& user, size_t limit) const {
+    std::vector<MessageRef> refs;
+    bool complete;
+    {
+        const RecentShard& recent_shard = *recent_by_user[shard_index(user)];
+        std::lock_guard<std::mutex> lock(recent_shard.mutex);
+        auto it = recent_shard.users.find(user);
+        if (it == recent_shard.users.end()) {
+            return {};
+        }
+        it->second.ring.newest(limit, refs);
+        complete = it->second.complete;
+    }
+
+    // A ring that has evicted entries can only answer if it still has `limit` of them
+    if (refs.size() < limit && !complete) {
+        return latest_involving(user, limit, [](const ChatMessage& msg) { return !is_removed(msg); });
+    }
+    return resolve_live(refs, limit);
+}
+
+std::vector<ChatMessage> MessageCache::recent(size_t limit) const {
+    std::vector<MessageRef> refs;
+    {
+        std::lock_guard<std::mutex> lock(recent_all_mutex);
+        recent_all.newest(limit, refs);
+    }
+    return resolve_live(refs, limit);
+}
+
+// ================== Unread Counters ==================
+bool MessageCache::counts_as_unread(const ChatMessage& msg) {
+    return !msg.is_read && !msg.is_deleted && !msg.deleted_by_receiver;
+}
+
+MessageCache::UnreadChange MessageCache::Shard::adjust_unread(const std::wstring& receiver,
+                                                             const std::wstring& sender, int delta) {
+    UnreadCounters& counters = unread[receiver];
+    counters.total += delta;
+    int count = (counters.by_sender[sender] += delta);
+    if (count == 0) {
+        counters.by_sender.erase(sender);
+        if (counters.by_sender.empty()) {
+            unread.erase(receiver);
+        }
+    }
+    return {true, receiver, sender, count};
+}
+
+int MessageCache::unread_count(const std::wstring& receiver) const {
+    const Shard& shard = *shards[shard_index(receiver)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.unread.find(receiver);
+    return it == shard.unread.end() ? 0 : it->second.total;
+}
+
+std::vector<std::pair<std::wstring, int>> MessageCache::unread_by_sender(const std::wstring& receiver) const {
+    const Shard& shard = *shards[shard_index(receiver)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.unread.find(receiver);
+    if (it == shard.unread.end()) {
+        return {};
+    }
+    return {it->second.by_sender.begin(), it->second.by_sender.end()};
+}
+
+int MessageCache::subscribe_unread(const std::wstring& receiver, UnreadListener listener) {
+    std::lock_guard<std::mutex> lock(listeners_mutex);
+    int id = next_subscription_id++;
+    unread_listeners[receiver][id] = std::move(listener);
+    subscription_receivers[id] = receiver;
+    return id;
+}
+
+void MessageCache::unsubscribe_unread(int subscription_id) {
+    std::lock_guard<std::mutex> lock(listeners_mutex);
+    auto it = subscription_receivers.find(subscription_id);
+    if (it == subscription_receivers.end()) return;
+
+    auto listeners = unread_listeners.find(it->second);
+    listeners->second.erase(subscription_id);
+    if (listeners->second.empty()) {
+        unread_listeners.erase(listeners);
+    }
+    subscription_receivers.erase(it);
+}
+
+void MessageCache::publish_unread(const UnreadChange& change) const {
+    if (!change.changed) return;
+
+    // Copy first so a listener may subscribe/unsubscribe while being notified
+    std::map<int, UnreadListener> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex);
+        auto it = unread_listeners.find(change.receiver);
+        if (it == unread_listeners.end()) return;
+        snapshot = it->second;
+    }
+    for (const auto& [subscription_id, listener] : snapshot) {
+        if (listener) listener(change.sender, change.count);
+    }
+}
+
+size_t MessageCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        total += shard->store.size();
+    }
+    return total;
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <map>
+#include <mutex>
+#include "MessageStore.h"
+#include "RecentRing.h"
+
+// Called after the subscribed receiver's unread count from one sender changes (count is the new value)
+using UnreadListener = std::function<void(const std::wstring& sender, int count)>;
+
+enum class Receipt {
+    Delivered,
+    Seen        // Also marks the message read
+};
+
+// Process-wide message cache shared by every MessageManager session.
+// Messages are sharded by receiver, so a user's inbox lives in one shard behind its own
+// reader/writer lock and unread queries touch a single shard. A separate directory,
+// sharded by id, records which shard holds each message for the by-id operations.
+// Nothing here hands out pointers: readers get copies or run a callback under the lock.
+class MessageCache {
+public:
+    explicit MessageCache(size_t shard_count = 64);
+
+    // False if a message with the same id is already cached
+    bool add(const ChatMessage& msg);
+    bool get(const std::wstring& id, ChatMessage& out) const;
+
+    // Runs fn on the cached message under the shard's write lock; returns what fn returns
+    // (false if the id is unknown). Keep fn short: no I/O, no calls back into the cache.
+    // The search text and unread counters are refreshed after a successful update.
+    bool update(const std::wstring& id, const std::function<bool(ChatMessage&)>& fn);
+
+    // Receipts are watermarks: marks the message and the earlier, not deleted messages of the
+    // same conversation (same sender and receiver) that do not have the receipt yet. The walk
+    // stops at the first earlier message that already has it. False if the id is unknown or
+    // deleted; otherwise sender and receiver name the conversation.
+    bool mark_up_to(const std::wstring& id, Receipt receipt, time_t when,
+                    std::wstring& sender, std::wstring& receiver);
+
+    void for_each_received(const std::wstring& user, const std::function<void(const ChatMessage&)>& fn) const;
+    // Messages the user sent or received, each visited once
+    void for_each_involving(const std::wstring& user, const std::function<void(const ChatMessage&)>& fn) const;
+    // Newest `limit` messages involving the user that pass keep(), oldest first
+    std::vector<ChatMessage> latest_involving(const std::wstring& user, size_t limit,
+                                              const std::function<bool(const ChatMessage&)>& keep) const;
+
+    // Newest `limit` messages not deleted by both sides, oldest first. Served from bounded
+    // rings of recent references (per user and process-wide), so the cost is O(limit);
+    // only a user whose ring cannot answer (limit above RECENT_PER_USER, or too many
+    // recent deletions) falls back to latest_involving.
+    static bool is_removed(const ChatMessage& msg);
+    std::vector<ChatMessage> recent_involving(const std::wstring& user, size_t limit) const;
+    std::vector<ChatMessage> recent(size_t limit) const;      // Across all users, up to RECENT_GLOBAL
+
+    // Non-deleted messages involving the user whose content, sender or receiver contains
+    // keyword (case-insensitive), oldest first. Ids of matches [offset, offset + limit)
+    // go to ids; returns the total number of matches.
+    size_t search_involving(const std::wstring& user, const std::wstring& keyword,
+                            std::vector<std::wstring>& ids, size_t offset, size_t limit) const;
+
+    // Unread = not read and not deleted for the receiver. Counters are kept per receiver
+    // and sender as messages are added and updated, so these never scan messages.
+    static bool counts_as_unread(const ChatMessage& msg);
+    int unread_count(const std::wstring& receiver) const;
+    std::vector<std::pair<std::wstring, int>> unread_by_sender(const std::wstring& receiver) const;  // By sender name
+
+    // Listeners run on the writing thread after the shard lock is released,
+    // and only for changes to the receiver they subscribed for
+    int subscribe_unread(const std::wstring& receiver, UnreadListener listener);   // Returns a subscription id
+    void unsubscribe_unread(int subscription_id);
+
+    size_t size() const;
+
+    static const size_t RECENT_PER_USER = 64;
+    static const size_t RECENT_GLOBAL = 1024;
+
+private:
+    struct MessageRef {
+        uint32_t shard;
+        size_t slot;
+
+        bool operator==(const MessageRef& other) const { return shard == other.shard && slot == other.slot; }
+    };
+
+    struct UserRecent {
+        RecentRing<MessageRef> ring{RECENT_PER_USER};
+        bool complete = true;               // Ring still holds every live message of the user
+    };
+
+    struct RecentShard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::wstring, UserRecent> users;
+    };
+
+    struct UnreadCounters {
+        int total = 0;
+        std::map<std::wstring, int> by_sender;   // Only senders with unread messages
+    };
+
+    struct UnreadChange {
+        bool changed = false;
+        std::wstring receiver;
+        std::wstring sender;
+        int count = 0;
+    };
+
+    struct SearchSpan {
+        size_t offset;
+        uint32_t length;
+        bool searchable;                    // False once deleted
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        MessageStore store;
+        std::vector<uint64_t> sequence;     // Global insertion order, by slot
+
+        // Folded UTF-8 search text of every slot, back to back, so a search streams through memory
+        std::string search_arena;
+        std::vector<SearchSpan> search_spans;   // By slot
+        size_t search_garbage = 0;              // Arena bytes left behind by edits
+
+        std::unordered_map<std::wstring, UnreadCounters> unread;   // By receiver
+
+        void set_search_text(size_t slot, const std::string& text, bool searchable);
+        UnreadChange adjust_unread(const std::wstring& receiver, const std::wstring& sender, int delta);
+    };
+
+    struct DirectoryShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::wstring, uint32_t> shard_of;   // Message id -> data shard
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::unique_ptr<DirectoryShard>> directory;
+    std::atomic<uint64_t> next_sequence{0};
+
+    std::vector<std::unique_ptr<RecentShard>> recent_by_user;   // Sharded by user name
+    RecentRing<MessageRef> recent_all{RECENT_GLOBAL};
+    mutable std::mutex recent_all_mutex;
+
+    std::unordered_map<std::wstring, std::map<int, UnreadListener>> unread_listeners;   // By receiver
+    std::unordered_map<int, std::wstring> subscription_receivers;
+    int next_subscription_id = 1;
+    mutable std::mutex listeners_mutex;
+
+    size_t shard_index(const std::wstring& key) const;
+    Shard* shard_holding(const std::wstring& id, uint32_t* index = nullptr) const;   // nullptr if the id is unknown
+    static std::string search_text(const ChatMessage& msg);
+    void publish_unread(const UnreadChange& change) const;
+
+    void remember_recent(const std::wstring& user, const MessageRef& ref);
+    void forget_recent(const std::wstring& user, const MessageRef& ref);
+    std::vector<ChatMessage> resolve_live(const std::vector<MessageRef>& refs, size_t limit) const;
+};
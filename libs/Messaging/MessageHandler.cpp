@@ -1,54 +1,168 @@
-#include "../include/MessageHandler.h"
-#include <random>
+#include "MessageHandler.h"
+#include "Utf8.h"
+#include "MessageId.h"
 #include <regex>
 #include <unordered_set>
 #include <iostream>
-#include <codecvt>
-#include <locale>
 #include <ctime>
 
-std::vector<ChatMessage> MessageManager::messages;
-Database* MessageManager::db = nullptr;
+MessageManager::MessageManager(std::shared_ptr<MessagingBackend> backend, const std::wstring& username)
+    : backend(backend), username(username) {}
+
+bool MessagingBackend::open_outbox(const std::string& path) {
+    auto journal = std::make_unique<Outbox>(path, [this](const OutboxEntry& entry) {
+        // Keyed by the message id, so a replay after a crash cannot store it twice
+        ChatMessage stored;
+        stored.id = entry.id;
+        stored.sender = entry.sender;
+        stored.receiver = entry.receiver;
+        stored.content = entry.content;
+        int row = store_once(stored);
+        if (row < 0) {
+            return false;
+        }
+        // Edits and deletes made while the message was queued had no row to write to either.
+        // Checked under db_mutex: an edit that finds the row from here on writes after us.
+        {
+            std::lock_guard<std::mutex> lock(db_mutex);
+            ChatMessage current;
+            if (cache->get(entry.id, current) && current.content != entry.content &&
+                !db->editMessage(row, wide_to_utf8(current.content))) {
+                return false;
+            }
+        }
+        bool seen = false, delivered = false;
+        cache->update(entry.id, [&](ChatMessage& msg) {
+            seen = msg.is_seen;
+            delivered = msg.is_delivered;
+            if (!msg.is_queued) {
+                return false;
+            }
+            msg.is_queued = false;
+            return true;
+        });
+        // Receipts that arrived while the message was queued had no row to point at
+        if (seen || delivered) {
+            receipts.add(entry.sender, entry.receiver, seen ? Receipt::Seen : Receipt::Delivered, row);
+        }
+        return true;
+    });
+
+    std::vector<OutboxEntry> pending;
+    if (!journal->open(pending)) {
+        return false;
+    }
+    for (const OutboxEntry& entry : pending) {
+        ChatMessage msg;
+        msg.id = entry.id;
+        msg.sender = entry.sender;
+        msg.receiver = entry.receiver;
+        msg.content = entry.content;
+        msg.timestamp = entry.timestamp;
+        msg.is_queued = true;
+        if (!entry.file_path.empty()) {
+            size_t last_slash = entry.file_path.find_last_of(L"/\\");
+            msg.has_attachment = true;
+            msg.file_path = entry.file_path;
+            msg.file_name = last_slash == std::wstring::npos ? entry.file_path : entry.file_path.substr(last_slash + 1);
+        }
+        cache->add(msg);
+    }
+    outbox = std::move(journal);
+    outbox->start();
+    return true;
+}
+
+int MessagingBackend::store_once(const ChatMessage& msg) {
+    int row;
+    {
+        std::lock_guard<std::mutex> lock(db_mutex);
+        if (!db) {
+            return -1;
+        }
+        row = db->storeMessageOnce(wide_to_utf8(msg.id), wide_to_utf8(msg.sender),
+                                   wide_to_utf8(msg.receiver), wide_to_utf8(msg.content));
+    }
+    if (row > 0) {
+        rows.remember(wide_to_utf8(msg.id), row);
+    }
+    return row;
+}
+
+// Only messages loaded from the database carry a numeric row id
+static bool db_row_id(const std::wstring& id, int& row) {
+    if (id.empty() || id.size() > 9) {
+        return false;
+    }
+    row = 0;
+    for (wchar_t ch : id) {
+        if (ch < L'0' || ch > L'9') {
+            return false;
+        }
+        row = row * 10 + (ch - L'0');
+    }
+    return row > 0;
+}
+
+bool MessagingBackend::row_of(const std::wstring& id, const std::wstring& sender, int& row) {
+    if (db_row_id(id, row)) {
+        return true;
+    }
+    std::string client_id = wide_to_utf8(id);
+    if (std::optional<int> known = rows.find(client_id)) {
+        row = *known;
+        return true;
+    }
+    if (!db) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(db_mutex);
+        row = db->findMessageByClientId(wide_to_utf8(sender), client_id);
+    }
+    if (row <= 0) {
+        return false;
+    }
+    rows.remember(client_id, row);
+    return true;
+}
 
-void MessageManager::initialize(Database* database, const std::wstring& username) {
-    db = database;
-    if (db) {
-        auto dbMessages = db->getUserChats(wstr_to_str(username));
-        for (const auto& dbMsg : dbMessages) {
-            messages.push_back(db_msg_to_your_msg(dbMsg));
+void MessageManager::initialize() {
+    if (backend->db) {
+        std::string user = wstr_to_str(username);
+        std::lock_guard<std::mutex> lock(backend->db_mutex);
+        for (const Chat& chat : backend->db->getUserChats(user)) {
+            auto dbMessages = chat.type == "chatroom" ? backend->db->getChatroomMessages(chat.name)
+                                                      : backend->db->getMessageHistory(user, chat.name);
+            for (const auto& dbMsg : dbMessages) {
+                // Another session may already have cached the same message
+                backend->cache->add(db_msg_to_your_msg(dbMsg));
+            }
         }
     }
 }
 
-void MessageManager::print_all_messages() {
-    for (const auto& msg : messages) {
+void MessageManager::print_all_messages() const {
+    backend->cache->for_each_involving(username, [](const ChatMessage& msg) {
         std::wcout << msg.sender << L" -> " << msg.receiver
                    << L": " << msg.content
                    << L" [" << get_message_status(msg) << L"]\n";
-    }
+    });
 }
 
+// Invalid sequences become U+FFFD instead of emptying the whole string
 std::wstring MessageManager::str_to_wstr(const std::string& str) {
-    try {
-        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-        return converter.from_bytes(str);
-    } catch (...) {
-        return L"";
-    }
+    return utf8_to_wide(str);
 }
 
 std::string MessageManager::wstr_to_str(const std::wstring& wstr) {
-    try {
-        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-        return converter.to_bytes(wstr);
-    } catch (...) {
-        return "";
-    }
+    return wide_to_utf8(wstr);
 }
 
-ChatMessage MessageManager::your_msg_to_db_msg(const ::ChatMessage& yourMsg) {
-    ChatMessage dbMsg;
+Message MessageManager::your_msg_to_db_msg(const ChatMessage& yourMsg) {
+    Message dbMsg;
 
+    dbMsg.id = 0;
     if (!yourMsg.id.empty()) {
         try {
             dbMsg.id = std::stoi(yourMsg.id);
@@ -72,8 +186,8 @@ ChatMessage MessageManager::your_msg_to_db_msg(const ::ChatMessage& yourMsg) {
     return dbMsg;
 }
 
-::ChatMessage MessageManager::db_msg_to_your_msg(const ChatMessage& dbMsg) {
-    ::ChatMessage yourMsg;
+ChatMessage MessageManager::db_msg_to_your_msg(const Message& dbMsg) {
+    ChatMessage yourMsg;
 
     yourMsg.id = std::to_wstring(dbMsg.id);
     yourMsg.sender = str_to_wstr(dbMsg.sender);
@@ -87,29 +201,21 @@ ChatMessage MessageManager::your_msg_to_db_msg(const ::ChatMessage& yourMsg) {
 
     yourMsg.is_read = dbMsg.isRead;
     yourMsg.is_editable = !dbMsg.isEdited;
+    if (dbMsg.forwardedFrom >= 0) {
+        yourMsg.is_forwarded = true;
+        yourMsg.original_sender = str_to_wstr(dbMsg.forwardOrigin);
+    }
 
     return yourMsg;
 }
 
-const ChatMessage* MessageManager::find_message(const std::wstring& id) {
-    for (const auto& msg : messages) {
-        if (msg.id == id && !msg.is_deleted) {
-            return &msg;
-        }
-    }
-    return nullptr;
+bool MessageManager::find_message(const std::wstring& id, ChatMessage& out) const {
+    return backend->cache->get(id, out) && !out.is_deleted;
 }
 
+// Time-ordered, so ids sort by creation time
 std::wstring generate_id() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-    const wchar_t* hex_chars = L"0123456789abcdef";
-    std::wstring id;
-    for (int i = 0; i < 32; ++i) {
-        id += hex_chars[dis(gen)];
-    }
-    return id;
+    return MessageId::next().to_wstring();
 }
 
 bool MessageManager::send(const ChatMessage& msg, const std::wstring& attachment_path) {
@@ -117,6 +223,33 @@ bool MessageManager::send(const ChatMessage& msg, const std::wstring& attachment
         return false;
     }
 
+    // A retry of a message this process already has costs one cache lookup: no rate limit
+    // token, no journal write and no database round trip
+    ChatMessage existing;
+    if (!msg.id.empty() && backend->cache->get(msg.id, existing)) {
+        if (existing.sender != msg.sender || existing.receiver != msg.receiver || existing.content != msg.content) {
+            LOG_WARN("message.duplicate", "❌ پیامی با این شناسه قبلاً ثبت شده است");
+            return false;
+        }
+        LOG_DEBUG("message.retry", "پیام تکراری نادیده گرفته شد");
+        last_sent_id = msg.id;
+        return true;
+    }
+
+    // Admission control before touching memory or the database
+    if (backend->rate_limiter) {
+        std::string sender = wstr_to_str(msg.sender);
+        std::string receiver = wstr_to_str(msg.receiver);
+        std::string conversation = sender < receiver ? sender + ":" + receiver : receiver + ":" + sender;
+        last_admission = backend->rate_limiter->tryAcquire(sender, conversation);
+        if (!last_admission.allowed) {
+            LOG_WARN("message.rate_limited", "⏳ تعداد پیام‌ها زیاد است، " +
+                                             std::to_string(last_admission.retryAfter.count()) +
+                                             " میلی‌ثانیه دیگر دوباره تلاش کنید");
+            return false;
+        }
+    }
+
     ChatMessage new_msg = msg;
     // new_msg.content = filterEmojis(new_msg.content); // Uncomment if needed
 
@@ -132,45 +265,71 @@ bool MessageManager::send(const ChatMessage& msg, const std::wstring& attachment
     if (new_msg.id.empty()) {
         new_msg.id = generate_id();
     }
-    messages.push_back(new_msg);
-
-    // Save to database
-    if (db) {
-        ChatMessage dbMsg = your_msg_to_db_msg(new_msg);
-        db->sendMessage(dbMsg.sender, dbMsg.receiver, dbMsg.content,
-                        dbMsg.timestamp, dbMsg.isRead, dbMsg.isEdited);
+    new_msg.is_queued = backend->outbox != nullptr;
+    if (!backend->cache->add(new_msg)) {
+        // A concurrent retry of the same message got there first
+        LOG_WARN("message.duplicate", "❌ پیامی با این شناسه قبلاً ثبت شده است");
+        return false;
     }
+    last_sent_id = new_msg.id;
+
+    // Durable in the journal is enough; the outbox flusher stores it in the database
+    if (backend->outbox) {
+        OutboxEntry entry;
+        entry.id = new_msg.id;
+        entry.sender = new_msg.sender;
+        entry.receiver = new_msg.receiver;
+        entry.content = new_msg.content;
+        entry.file_path = new_msg.file_path;
+        entry.timestamp = new_msg.timestamp;
+        if (backend->outbox->append(entry)) {
+            LOG_INFO("message.sent",
+                     "✅ پیام با موفقیت ارسال شد (" + std::to_string(new_msg.content.length()) + " کاراکتر)");
+            return true;
+        }
+        // Journal unwritable: fall back to a direct database write
+        backend->cache->update(new_msg.id, [](ChatMessage& cached) {
+            cached.is_queued = false;
+            return true;
+        });
+    }
+
+    // Save to database, keyed by the message id like the outbox does
+    backend->store_once(new_msg);
 
-    std::wcout << L"✅ پیام با موفقیت ارسال شد (" << new_msg.content.length() << L" کاراکتر)\n";
+    LOG_INFO("message.sent",
+             "✅ پیام با موفقیت ارسال شد (" + std::to_string(new_msg.content.length()) + " کاراکتر)");
     return true;
 }
 
+long long MessageManager::get_retry_after_ms() const {
+    return last_admission.allowed ? 0 : last_admission.retryAfter.count();
+}
+
 bool MessageManager::edit_message(const std::wstring& id,
                                   const std::wstring& new_content,
                                   const std::wstring& requester_username) {
-    for (auto& msg : messages) {
-        if (msg.id == id && msg.sender == requester_username) {
-            if (!can_edit_message(msg)) {
-                return false;
-            }
-
-            msg.content = new_content;
-
-            // Update in database
-            if (db) {
-                try {
-                    int messageId = std::stoi(wstr_to_str(id));
-                    ChatMessage dbMsg = your_msg_to_db_msg(msg);
-                    db->updateMessage(messageId, dbMsg.content);
-                } catch (...) {
-                    return false;
-                }
-            }
-
-            return true;
+    ChatMessage edited;
+    bool updated = backend->cache->update(id, [&](ChatMessage& msg) {
+        if (msg.sender != requester_username || !can_edit_message(msg)) {
+            return false;
         }
+        msg.content = new_content;
+        edited = msg;
+        return true;
+    });
+    if (!updated) {
+        return false;
     }
-    return false;
+
+    // Update in database
+    int row;
+    if (backend->db && backend->row_of(id, edited.sender, row)) {
+        std::lock_guard<std::mutex> lock(backend->db_mutex);
+        return backend->db->editMessage(row, wstr_to_str(edited.content));
+    }
+
+    return true;
 }
 
 bool MessageManager::can_edit_message(const ChatMessage& msg) {
@@ -184,46 +343,36 @@ bool MessageManager::can_edit_message(const ChatMessage& msg) {
 }
 
 bool MessageManager::delete_message(const std::wstring& id, const std::wstring& username) {
-    for (auto& msg : messages) {
-        if (msg.id == id) {
-            if (msg.sender == username) {
-                msg.deleted_by_sender = true;
-            } else if (msg.receiver == username) {
-                msg.deleted_by_receiver = true;
-            } else {
-                return false;
-            }
-
-            if (msg.deleted_by_sender && msg.deleted_by_receiver) {
-                msg.content = L"این پیام حذف شده است";
-                msg.is_editable = false;
-
-                // Delete from database
-                if (db) {
-                    try {
-                        int messageId = std::stoi(wstr_to_str(id));
-                        db->deleteMessage(messageId);
-                    } catch (...) {
-                        return false;
-                    }
-                }
-            } else {
-                // Update in database for soft delete
-                if (db) {
-                    try {
-                        int messageId = std::stoi(wstr_to_str(id));
-                        ChatMessage dbMsg = your_msg_to_db_msg(msg);
-                        db->updateMessage(messageId, dbMsg.content);
-                    } catch (...) {
-                        return false;
-                    }
-                }
-            }
+    ChatMessage deleted;
+    bool updated = backend->cache->update(id, [&](ChatMessage& msg) {
+        if (msg.sender == username) {
+            msg.deleted_by_sender = true;
+        } else if (msg.receiver == username) {
+            msg.deleted_by_receiver = true;
+        } else {
+            return false;
+        }
 
-            return true;
+        if (msg.deleted_by_sender && msg.deleted_by_receiver) {
+            msg.content = L"این پیام حذف شده است";
+            msg.is_editable = false;
         }
+        deleted = msg;
+        return true;
+    });
+    if (!updated) {
+        return false;
     }
-    return false;
+
+    // The schema has no per-side deletion flags: only the placeholder both sides see is stored,
+    // and it reloads as a non-editable message
+    int row;
+    if (backend->db && deleted.deleted_by_sender && deleted.deleted_by_receiver && backend->row_of(id, deleted.sender, row)) {
+        std::lock_guard<std::mutex> lock(backend->db_mutex);
+        return backend->db->editMessage(row, wstr_to_str(deleted.content));
+    }
+
+    return true;
 }
 
 bool MessageManager::is_message_deleted(const ChatMessage& msg) {
@@ -231,22 +380,35 @@ bool MessageManager::is_message_deleted(const ChatMessage& msg) {
 }
 
 bool MessageManager::forward_message(const std::wstring& id, const std::wstring& new_receiver) {
-    const ChatMessage* original = find_message(id);
-    if (original) {
-        ChatMessage forwarded_msg = *original;
+    ChatMessage original;
+    if (find_message(id, original)) {
+        ChatMessage forwarded_msg = original;
         forwarded_msg.id = generate_id();
         forwarded_msg.receiver = new_receiver;
         forwarded_msg.is_forwarded = true;
         forwarded_msg.timestamp = time(nullptr);
-
-        // Save to database
-        if (db) {
-            ChatMessage dbMsg = your_msg_to_db_msg(forwarded_msg);
-            db->sendMessage(dbMsg.sender, dbMsg.receiver, dbMsg.content,
-                            dbMsg.timestamp, dbMsg.isRead, dbMsg.isEdited);
+        // A new message for the new receiver: none of the original's receipts apply
+        forwarded_msg.is_read = forwarded_msg.is_delivered = forwarded_msg.is_seen = false;
+        forwarded_msg.is_queued = false;
+
+        // The body is shared in message_bodies. Nothing new was typed, so there is nothing for
+        // the outbox to make durable first: the forward is one transaction, reported if it fails.
+        if (backend->db) {
+            int original_row;
+            if (!backend->row_of(original.id, original.sender, original_row)) {
+                original_row = -1;      // Still queued in the outbox
+            }
+            const std::wstring& origin = original.original_sender.empty() ? original.sender : original.original_sender;
+            std::lock_guard<std::mutex> lock(backend->db_mutex);
+            if (!backend->db->forwardMessage(wide_to_utf8(forwarded_msg.sender), wide_to_utf8(new_receiver),
+                                             wide_to_utf8(forwarded_msg.content), original_row,
+                                             wide_to_utf8(origin),
+                                             wide_to_utf8(forwarded_msg.id))) {
+                return false;
+            }
         }
 
-        messages.push_back(forwarded_msg);
+        backend->cache->add(forwarded_msg);
         return true;
     }
     return false;
@@ -261,19 +423,15 @@ ChatMessage MessageManager::create_reply(const std::wstring& original_id, const
     reply.content = reply_content;
     reply.timestamp = time(nullptr);
 
-    const ChatMessage* original = find_message(original_id);
-    if (original) {
-        reply.receiver = original->sender;
-        reply.replied_to_content = original->content;
-        reply.replied_to_sender = original->sender;
+    ChatMessage original;
+    if (find_message(original_id, original)) {
+        reply.receiver = original.sender;
+        reply.replied_to_content = original.content;
+        reply.replied_to_sender = original.sender;
     }
 
-    // Save to database
-    if (db) {
-        ChatMessage dbMsg = your_msg_to_db_msg(reply);
-        db->sendMessage(dbMsg.sender, dbMsg.receiver, dbMsg.content,
-                        dbMsg.timestamp, dbMsg.isRead, dbMsg.isEdited);
-    }
+    // Save to database; keyed by the reply's id, so sending it afterwards does not store it twice
+    backend->store_once(reply);
 
     return reply;
 }
@@ -287,98 +445,83 @@ std::wstring MessageManager::get_reply_preview(const ChatMessage& msg) {
            msg.replied_to_sender + L": " + msg.content;
 }
 
-std::vector<ChatMessage> MessageManager::get_last_messages(int limit) {
-    std::vector<ChatMessage> active_messages;
-    for (const auto& msg : messages) {
-        if (!(msg.deleted_by_sender && msg.deleted_by_receiver)) {
-            active_messages.push_back(msg);
-        }
-    }
-
-    limit = std::min(limit, static_cast<int>(active_messages.size()));
-    return {active_messages.end() - limit, active_messages.end()};
+std::vector<ChatMessage> MessageManager::get_last_messages(int limit) const {
+    // Served from the user's ring of recent messages: O(limit), no history scan
+    return backend->cache->recent_involving(username, static_cast<size_t>(std::max(limit, 0)));
 }
 
-std::vector<std::wstring> MessageManager::get_unread_senders(const std::wstring& user) {
+// Senders with unread messages for the user, one entry each, by name
+std::vector<std::wstring> MessageManager::get_unread_senders(const std::wstring& user) const {
     std::vector<std::wstring> senders;
-    for (const auto& msg : messages) {
-        if (!msg.is_deleted && msg.receiver == user && !msg.is_read) {
-            senders.push_back(msg.sender);
-        }
+    for (const auto& [sender, count] : backend->cache->unread_by_sender(user)) {
+        senders.push_back(sender);
     }
     return senders;
 }
 
-std::vector<std::pair<std::wstring, int>> MessageManager::get_unread_notifications(const std::wstring& user) {
-    std::map<std::wstring, int> sender_count;
-
-    for (const auto& msg : messages) {
-        if (!msg.is_deleted && msg.receiver == user && !msg.is_read) {
-            sender_count[msg.sender]++;
-        }
-    }
+std::vector<std::pair<std::wstring, int>> MessageManager::get_unread_notifications(const std::wstring& user) const {
+    return backend->cache->unread_by_sender(user);
+}
 
-    std::vector<std::pair<std::wstring, int>> notifications;
-    for (const auto& [sender, count] : sender_count) {
-        notifications.emplace_back(sender, count);
-    }
+int MessageManager::get_unread_count(const std::wstring& user) const {
+    return backend->cache->unread_count(user);
+}
 
-    return notifications;
+int MessageManager::on_unread_change(UnreadListener listener) {
+    return backend->cache->subscribe_unread(username, std::move(listener));
 }
 
-int MessageManager::get_unread_count(const std::wstring& user) {
-    return std::count_if(messages.begin(), messages.end(),
-                         [&user](const ChatMessage& m) {
-                             return !m.is_deleted && m.receiver == user && !m.is_read;
-                         });
+void MessageManager::remove_unread_listener(int subscription_id) {
+    backend->cache->unsubscribe_unread(subscription_id);
 }
 
-bool MessageManager::mark_as_delivered(const std::wstring& id) {
-    for (auto& msg : messages) {
-        if (msg.id == id && !msg.is_deleted) {
-            msg.is_delivered = true;
-            msg.delivered_time = time(nullptr);
-
-            // Update in database
-            if (db) {
-                try {
-                    int messageId = std::stoi(wstr_to_str(id));
-                    db->markAsDelivered(messageId);
-                } catch (...) {
-                    return false;
-                }
-            }
+int MessageManager::search_message_ids(const std::wstring& keyword, std::vector<std::wstring>& ids,
+                                       size_t offset, size_t limit) const {
+    return static_cast<int>(backend->cache->search_involving(username, keyword, ids, offset, limit));
+}
 
-            return true;
+std::pair<int, std::vector<ChatMessage>> MessageManager::search_messages(const std::wstring& keyword,
+                                                                         size_t offset, size_t limit) const {
+    std::vector<std::wstring> ids;
+    int total = search_message_ids(keyword, ids, offset, limit);
+
+    std::vector<ChatMessage> results;
+    results.reserve(ids.size());
+    for (const auto& id : ids) {
+        ChatMessage msg;
+        if (backend->cache->get(id, msg)) {
+            results.push_back(std::move(msg));
         }
     }
-    return false;
+    return {total, std::move(results)};
 }
 
-bool MessageManager::mark_as_seen(const std::wstring& id) {
-    for (auto& msg : messages) {
-        if (msg.id == id && !msg.is_deleted) {
-            msg.is_seen = true;
-            msg.seen_time = time(nullptr);
-
-            // Update in database
-            if (db) {
-                try {
-                    int messageId = std::stoi(wstr_to_str(id));
-                    db->markAsSeen(messageId);
-                } catch (...) {
-                    return false;
-                }
-            }
+bool MessageManager::mark_receipt(const std::wstring& id, Receipt receipt) {
+    std::wstring sender, receiver;
+    if (!backend->cache->mark_up_to(id, receipt, time(nullptr), sender, receiver)) {
+        return false;
+    }
 
-            return true;
-        }
+    // A queued message has no row yet; the outbox flusher adds its receipt once it is stored
+    int row;
+    if (backend->db && backend->row_of(id, sender, row)) {
+        backend->receipts.add(sender, receiver, receipt, row);
     }
-    return false;
+    return true;
+}
+
+bool MessageManager::mark_as_delivered(const std::wstring& id) {
+    return mark_receipt(id, Receipt::Delivered);
+}
+
+bool MessageManager::mark_as_seen(const std::wstring& id) {
+    return mark_receipt(id, Receipt::Seen);
 }
 
 std::wstring MessageManager::get_message_status(const ChatMessage& msg) {
-    if (msg.is_seen) {
+    if (msg.is_queued) {
+        return L"🕓 در صف ارسال";
+    } else if (msg.is_seen) {
         return L"✅ دیده شده";
     } else if (msg.is_delivered) {
         return L"✓✓ تحویل شده";
@@ -389,7 +532,7 @@ std::wstring MessageManager::get_message_status(const ChatMessage& msg) {
 
 bool MessageManager::is_valid_message(const std::wstring& content) {
     if (content.empty()) {
-        std::wcout << L"❌ پیام نمی‌تواند خالی باشد\n";
+        LOG_WARN("message.invalid", "❌ پیام نمی‌تواند خالی باشد");
         return false;
     }
 
@@ -402,12 +545,12 @@ bool MessageManager::is_valid_message(const std::wstring& content) {
     }
 
     if (!has_meaningful_content) {
-        std::wcout << L"❌ پیام باید محتوای معنادار داشته باشد\n";
+        LOG_WARN("message.invalid", "❌ پیام باید محتوای معنادار داشته باشد");
         return false;
     }
 
     if (content.length() > 1000) {
-        std::wcout << L"❌ پیام نمی‌تواند بیشتر از 1000 کاراکتر باشد\n";
+        LOG_WARN("message.invalid", "❌ پیام نمی‌تواند بیشتر از 1000 کاراکتر باشد");
         return false;
     }
 
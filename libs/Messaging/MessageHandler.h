@@ -5,107 +5,112 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
-#include <codecvt>
-#include <locale>
 #include <map>
+#include <memory>
+#include <mutex>
 #include "Database.h"
+#include "RateLimiter.h"
+#include "Logger.h"
+#include "MessageStore.h"
+#include "MessageCache.h"
+#include "ReceiptCoalescer.h"
+#include "Outbox.h"
 
-struct ChatMessage {
-    std::wstring id;
-    std::wstring sender;
-    std::wstring receiver;
-    std::wstring content;
-    std::wstring original_sender;
-    std::wstring replied_to_id;
-    std::wstring replied_to_content;
-    std::wstring replied_to_sender;
-    time_t edit_expiry_time;
-    time_t timestamp;
-    bool is_read = false;
-    bool is_editable = true;
-    bool is_deleted = false;
-    bool deleted_by_sender = false;
-    bool deleted_by_receiver = false;
-    bool is_delivered = false;
-    bool is_seen = false;
-    time_t delivered_time = 0;
-    time_t seen_time = 0;
-    bool is_forwarded = false;
-    std::wstring file_path;
-    std::wstring file_name;
-    bool has_attachment = false;
+// Everything the sessions of one process share
+struct MessagingBackend {
+    std::shared_ptr<MessageCache> cache = std::make_shared<MessageCache>();
+    Database* db = nullptr;
+    std::mutex db_mutex;                        // One SQLite connection: one statement at a time
+    std::shared_ptr<RateLimiter> rate_limiter;  // Optional admission control
+    // Rows store_once() returned, by client message id. Recent ids only: row_of() falls back
+    // to a lookup by (sender, client_id). Declared before receipts and outbox, whose threads use it.
+    DedupWindow rows{std::chrono::seconds(600), 1 << 16};
 
-    std::wstring get_formatted_time() const {
-        std::tm tm;
-#ifdef _WIN32
-        localtime_s(&tm, &timestamp);
-#else
-        localtime_r(&timestamp, &tm);
-#endif
-        std::wstringstream wss;
-        wss << std::put_time(&tm, L"%Y-%m-%d %H:%M:%S");
-        return wss.str();
-    }
+    // Delivered/seen receipts are written as batched watermarks. Declared after everything
+    // its flusher touches: it is destroyed before them and flushes while db is still usable.
+    ReceiptCoalescer receipts{[this](const std::vector<ReceiptWatermark>& batch) {
+        if (!db) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(db_mutex);
+        return db->applyReceiptWatermarks(batch) >= 0;
+    }};
+
+    // Optional durable send journal: with it, send() returns once the message is in the
+    // journal and a background flusher writes it to db. Declared last: destroyed first.
+    std::unique_ptr<Outbox> outbox;
+    // Opens the journal, puts entries an earlier run did not deliver back into the cache
+    // (as queued) and starts delivering them. False if the journal cannot be opened.
+    bool open_outbox(const std::string& path);
+
+    // Idempotent insert keyed by the message id (the row's client_id); returns the row id, -1 on failure
+    int store_once(const ChatMessage& msg);
+    // Database row of a message: its id if it was loaded from the database, otherwise the row
+    // stored under its client id. False while the message is not stored yet.
+    bool row_of(const std::wstring& id, const std::wstring& sender, int& row);
 };
 
+// One user's session. Sessions are cheap (a pointer and a name) and can run on
+// different threads; shared state lives in MessagingBackend.
 class MessageManager {
 private:
-    static std::vector<ChatMessage> messages;
-    static Database* db;
+    std::shared_ptr<MessagingBackend> backend;
+    std::wstring username;
+    AdmissionDecision last_admission;
+    std::wstring last_sent_id;
 
-    static bool contains_ignore_case(const std::wstring& str, const std::wstring& keyword) {
-        auto it = std::search(
-                str.begin(), str.end(),
-                keyword.begin(), keyword.end(),
-                [](wchar_t ch1, wchar_t ch2) {
-                    return std::towlower(ch1) == std::towlower(ch2);
-                }
-        );
-        return it != str.end();
-    }
-
-    static const ChatMessage* find_message(const std::wstring& id);
+    bool find_message(const std::wstring& id, ChatMessage& out) const;
+    bool mark_receipt(const std::wstring& id, Receipt receipt);
 
 public:
-    static void initialize(Database* database, const std::wstring& username);
-    static void print_all_messages();
+    MessageManager(std::shared_ptr<MessagingBackend> backend, const std::wstring& username);
+
+    void initialize();      // Loads the user's history from the database into the shared cache
+    void print_all_messages() const;
+    const std::wstring& get_username() const { return username; }
 
     static std::wstring str_to_wstr(const std::string& str);
     static std::string wstr_to_str(const std::wstring& wstr);
 
-    static ::ChatMessage db_msg_to_your_msg(const ChatMessage& dbMsg);
-    static ChatMessage your_msg_to_db_msg(const ::ChatMessage& yourMsg);
+    // Database rows carry UTF-8 text and an integer id; cached messages use wide strings
+    static ChatMessage db_msg_to_your_msg(const Message& dbMsg);
+    static Message your_msg_to_db_msg(const ChatMessage& yourMsg);
 
-    static bool send(const ChatMessage& msg, const std::wstring& attachment_path = L"");
-    static bool edit_message(const std::wstring& id,
-                             const std::wstring& new_content,
-                             const std::wstring& requester_username);
+    // With backend->outbox the database write is asynchronous: the message is durable in the
+    // journal on return and shows as queued until the flusher has stored it.
+    // A client-chosen msg.id is an idempotency key: retrying the same message returns true
+    // without storing it again, and get_last_sent_id() names the message either way.
+    bool send(const ChatMessage& msg, const std::wstring& attachment_path = L"");
+    const std::wstring& get_last_sent_id() const { return last_sent_id; }
+    long long get_retry_after_ms() const;
+    bool edit_message(const std::wstring& id,
+                      const std::wstring& new_content,
+                      const std::wstring& requester_username);
     static bool can_edit_message(const ChatMessage& msg);
-    static bool delete_message(const std::wstring& id, const std::wstring& username);
+    bool delete_message(const std::wstring& id, const std::wstring& username);
     static bool is_message_deleted(const ChatMessage& msg);
-    static bool mark_as_delivered(const std::wstring& id);
-    static bool mark_as_seen(const std::wstring& id);
+    // Receipts are watermarks: earlier messages of the same conversation are marked too.
+    // Memory is updated immediately; the database write is batched by backend->receipts.
+    bool mark_as_delivered(const std::wstring& id);
+    bool mark_as_seen(const std::wstring& id);
     static bool is_valid_message(const std::wstring& content);
     static std::wstring get_message_status(const ChatMessage& msg);
-    static bool forward_message(const std::wstring& id, const std::wstring& new_receiver);
-    static ChatMessage create_reply(const std::wstring& original_id, const std::wstring& sender,
-                                    const std::wstring& reply_content);
+    bool forward_message(const std::wstring& id, const std::wstring& new_receiver);
+    ChatMessage create_reply(const std::wstring& original_id, const std::wstring& sender,
+                             const std::wstring& reply_content);
     static std::wstring get_reply_preview(const ChatMessage& msg);
-    static std::vector<ChatMessage> get_last_messages(int limit = 10);
-    static std::vector<std::wstring> get_unread_senders(const std::wstring& user);
-    static std::vector<std::pair<std::wstring, int>> get_unread_notifications(const std::wstring& user);
-    static int get_unread_count(const std::wstring& user);
+    std::vector<ChatMessage> get_last_messages(int limit = 10) const;
+    std::vector<std::wstring> get_unread_senders(const std::wstring& user) const;
+    std::vector<std::pair<std::wstring, int>> get_unread_notifications(const std::wstring& user) const;
+    int get_unread_count(const std::wstring& user) const;
+    // Notifies this session's user when an unread count changes; returns a subscription id
+    int on_unread_change(UnreadListener listener);
+    void remove_unread_listener(int subscription_id);
 
-    static std::pair<int, std::vector<ChatMessage>> search_messages(const std::wstring& keyword) {
-        std::vector<ChatMessage> results;
-        for (const auto& msg : messages) {
-            if (!msg.is_deleted &&
-                (contains_ignore_case(msg.content, keyword) ||
-                 contains_ignore_case(msg.sender, keyword) ||
-                 contains_ignore_case(msg.receiver, keyword))) {
-                results.push_back(msg);
-            }
-        }
-        return {results.size(), results};
-    }
+    // Case-insensitive match on content, sender or receiver, oldest first.
+    // Both return the total number of matches; only [offset, offset + limit) is materialized.
+    int search_message_ids(const std::wstring& keyword, std::vector<std::wstring>& ids,
+                           size_t offset = 0, size_t limit = 50) const;
+    std::pair<int, std::vector<ChatMessage>> search_messages(const std::wstring& keyword,
+                                                             size_t offset = 0, size_t limit = 50) const;
 };
@@ -0,0 +1,97 @@
+#include "MessageId.h"
+#include <chrono>
+#include <random>
+#include <atomic>
+
+static const wchar_t* const CROCKFORD = L"0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+// ================== Generation ==================
+static uint32_t process_tag() {
+    // One random_device read per process, not per id
+    static const uint32_t tag = [] {
+        std::random_device rd;
+        return static_cast<uint32_t>(rd());
+    }();
+    return tag;
+}
+
+static uint64_t now_ms() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+MessageId MessageId::next() {
+    static std::atomic<uint32_t> next_thread_tag{0};
+
+    struct ThreadState {
+        uint64_t last_ms = 0;
+        uint32_t sequence = 0;
+        uint16_t thread_tag = static_cast<uint16_t>(next_thread_tag.fetch_add(1, std::memory_order_relaxed));
+        uint32_t process = process_tag();
+    };
+    thread_local ThreadState state;
+
+    // Never step back in time, even if the wall clock does
+    uint64_t ms = now_ms();
+    if (ms < state.last_ms) {
+        ms = state.last_ms;
+    }
+    if (ms == state.last_ms) {
+        if (++state.sequence == 0) {
+            ms++;       // 2^32 ids in one millisecond: borrow the next one
+        }
+    } else {
+        state.sequence = 0;
+    }
+    state.last_ms = ms;
+
+    MessageId id;
+    id.high = (ms << 16) | (state.process >> 16);
+    id.low = (static_cast<uint64_t>(state.process & 0xFFFF) << 48) |
+             (static_cast<uint64_t>(state.thread_tag) << 32) | state.sequence;
+    return id;
+}
+
+// ================== Text Form ==================
+void MessageId::format(wchar_t out[26]) const {
+    // 128 bits as 26 base32 digits, most significant first (the first digit holds 3 bits)
+    uint64_t hi = high, lo = low;
+    for (int i = 25; i >= 0; i--) {
+        out[i] = CROCKFORD[lo & 0x1F];
+        lo = (lo >> 5) | (hi << 59);
+        hi >>= 5;
+    }
+}
+
+std::wstring MessageId::to_wstring() const {
+    wchar_t text[26];
+    format(text);
+    return std::wstring(text, 26);
+}
+
+static int crockford_value(wchar_t ch) {
+    if (ch >= L'0' && ch <= L'9') return ch - L'0';
+    if (ch >= L'a' && ch <= L'z') ch = static_cast<wchar_t>(ch - L'a' + L'A');
+    for (int value = 10; value < 32; value++) {
+        if (CROCKFORD[value] == ch) return value;
+    }
+    return -1;
+}
+
+bool MessageId::parse(const std::wstring& text, MessageId& out) {
+    if (text.size() != 26) {
+        return false;
+    }
+    uint64_t hi = 0, lo = 0;
+    for (size_t i = 0; i < 26; i++) {
+        int value = crockford_value(text[i]);
+        if (value < 0 || (i == 0 && value > 7)) {
+            return false;
+        }
+        hi = (hi << 5) | (lo >> 59);
+        lo = (lo << 5) | static_cast<uint64_t>(value);
+    }
+    out.high = hi;
+    out.low = lo;
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// 128-bit time-ordered message id (ULID-like):
+//   48 bits  Unix time in milliseconds
+//   32 bits  process tag, random per process
+//   16 bits  thread tag, assigned per generating thread (wraps after 65536 threads)
+//   32 bits  per-thread sequence
+// Ids from one thread are strictly increasing; ids from different threads are ordered
+// by millisecond. Comparing ids (binary or text form) therefore sorts by creation time.
+struct MessageId {
+    uint64_t high = 0;      // Timestamp, upper half of the process tag
+    uint64_t low = 0;       // Lower half of the process tag, thread tag, sequence
+
+    // Thread-safe and lock-free: all generator state is thread-local
+    static MessageId next();
+
+    uint64_t timestamp_ms() const { return high >> 16; }
+
+    // 26-character Crockford base32 text; lexicographic order equals id order
+    std::wstring to_wstring() const;
+    void format(wchar_t out[26]) const;
+    // False if text is not a 26-character id
+    static bool parse(const std::wstring& text, MessageId& out);
+
+    bool operator==(const MessageId& other) const { return high == other.high && low == other.low; }
+    bool operator!=(const MessageId& other) const { return !(*this == other); }
+    bool operator<(const MessageId& other) const {
+        return high != other.high ? high < other.high : low < other.low;
+    }
+};
+
+namespace std {
+template <>
+struct hash<MessageId> {
+    size_t operator()(const MessageId& id) const {
+        return static_cast<size_t>(id.high * 0x9E3779B97F4A7C15ULL ^ id.low);
+    }
+};
+}
@@ -0,0 +1,341 @@
+#include "MessageStore.h"
+#include "Utf8.h"
+
+const std::vector<size_t> MessageStore::no_slots;
+
+// FNV-1a; equal bodies are still compared byte for byte before they are shared
+static uint64_t text_hash(const char* text, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// A text id is packed only if it is exactly the canonical text of a MessageId
+static bool pack_id(const std::wstring& text, MessageId& id) {
+    return MessageId::parse(text, id) && id.to_wstring() == text;
+}
+
+uint32_t MessageStore::intern(const std::wstring& name) {
+    auto it = participant_ids.find(name);
+    if (it != participant_ids.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(participants.size());
+    participants.push_back(name);
+    participant_ids.emplace(name, index);
+    by_receiver.emplace_back();
+    by_sender.emplace_back();
+    return index;
+}
+
+// ================== Mutation ==================
+bool MessageStore::add(const ChatMessage& msg) {
+    size_t slot = records.size();
+    Record record{};
+    if (pack_id(msg.id, record.id)) {
+        if (!by_id.emplace(record.id, slot).second) {
+            return false;
+        }
+    } else {
+        if (!by_text_id.emplace(msg.id, slot).second) {
+            return false;
+        }
+        record.id = MessageId();
+        record.flags |= EXTRA_TEXT_ID;
+        text_ids.emplace(slot, msg.id);
+    }
+
+    record.sender = intern(msg.sender);
+    record.receiver = intern(msg.receiver);
+    records.push_back(record);
+    // Stored in place: compacting the content arena relocates every record in records
+    store_fields(slot, records.back(), msg);
+    by_receiver[record.receiver].push_back(slot);
+    by_sender[record.sender].push_back(slot);
+    return true;
+}
+
+void MessageStore::replace(size_t slot, const ChatMessage& msg) {
+    store_fields(slot, records[slot], msg);
+}
+
+void MessageStore::mark_delivered(size_t slot, time_t when) {
+    Record& record = records[slot];
+    record.flags |= FLAG_DELIVERED;
+    record.delivered_time = when;
+}
+
+void MessageStore::mark_seen(size_t slot, time_t when) {
+    Record& record = records[slot];
+    if (!(record.flags & FLAG_DELIVERED)) {
+        record.flags |= FLAG_DELIVERED;
+        record.delivered_time = when;
+    }
+    record.flags |= FLAG_SEEN | FLAG_READ;
+    record.seen_time = when;
+}
+
+// Everything except id and participants; keeps the side tables in step with the message
+void MessageStore::store_fields(size_t slot, Record& record, const ChatMessage& msg) {
+    uint16_t flag = record.flags & (EXTRA_TEXT_ID | EXTRA_SHARED_BODY);
+    if (msg.is_read) flag |= FLAG_READ;
+    if (msg.is_editable) flag |= FLAG_EDITABLE;
+    if (msg.is_deleted) flag |= FLAG_DELETED;
+    if (msg.deleted_by_sender) flag |= FLAG_DELETED_BY_SENDER;
+    if (msg.deleted_by_receiver) flag |= FLAG_DELETED_BY_RECEIVER;
+    if (msg.is_delivered) flag |= FLAG_DELIVERED;
+    if (msg.is_seen) flag |= FLAG_SEEN;
+    if (msg.is_forwarded) flag |= FLAG_FORWARDED;
+    if (msg.has_attachment) flag |= FLAG_HAS_ATTACHMENT;
+    if (msg.is_queued) flag |= FLAG_QUEUED;
+
+    if (!msg.replied_to_id.empty() || !msg.replied_to_content.empty() || !msg.replied_to_sender.empty()) {
+        flag |= EXTRA_REPLY;
+        replies[slot] = {msg.replied_to_id, msg.replied_to_content, msg.replied_to_sender};
+    } else if (record.flags & EXTRA_REPLY) {
+        replies.erase(slot);
+    }
+    if (!msg.original_sender.empty()) {
+        flag |= EXTRA_ORIGIN;
+        origins[slot] = intern(msg.original_sender);
+    } else if (record.flags & EXTRA_ORIGIN) {
+        origins.erase(slot);
+    }
+    if (!msg.file_path.empty() || !msg.file_name.empty()) {
+        flag |= EXTRA_FILE;
+        attachments[slot] = {msg.file_path, msg.file_name};
+    } else if (record.flags & EXTRA_FILE) {
+        attachments.erase(slot);
+    }
+
+    record.flags = flag;
+    record.timestamp = msg.timestamp;
+    record.edit_expiry_time = msg.edit_expiry_time;
+    record.delivered_time = msg.delivered_time;
+    record.seen_time = msg.seen_time;
+    store_content(record, msg.content);
+}
+
+// Edits append the new text; compact once more than half of the arena is stale
+void MessageStore::store_content(Record& record, const std::wstring& content) {
+    std::string utf8 = wide_to_utf8(content);
+    if (utf8.size() == record.content_length &&
+        content_arena.compare(record.content_offset, record.content_length, utf8) == 0) {
+        return;     // Unchanged (status updates): nothing to append
+    }
+    release_content(record);
+
+    // A forward points at an earlier copy of the same text instead of appending another
+    bool share = (record.flags & FLAG_FORWARDED) && !utf8.empty();
+    uint64_t hash = share ? text_hash(utf8.data(), utf8.size()) : 0;
+    if (share) {
+        auto found = shared_bodies.find(hash);
+        if (found != shared_bodies.end() && found->second.length == utf8.size() &&
+            content_arena.compare(found->second.offset, found->second.length, utf8) == 0) {
+            found->second.refs++;
+            record.content_offset = found->second.offset;
+            record.content_length = found->second.length;
+            record.flags |= EXTRA_SHARED_BODY;
+            return;
+        }
+    }
+
+    record.content_offset = content_arena.size();
+    record.content_length = static_cast<uint32_t>(utf8.size());
+    content_arena += utf8;
+    // On a hash collision the text stays private to this record
+    if (share && shared_bodies.emplace(hash, SharedBody{record.content_offset, record.content_length, 1}).second) {
+        record.flags |= EXTRA_SHARED_BODY;
+    }
+
+    if (content_garbage > content_arena.size() / 2) {
+        compact_arena();
+    }
+}
+
+// The record's current text becomes garbage, unless other forwards still point at it
+void MessageStore::release_content(Record& record) {
+    if (record.flags & EXTRA_SHARED_BODY) {
+        record.flags &= static_cast<uint16_t>(~EXTRA_SHARED_BODY);
+        auto found = shared_bodies.find(text_hash(content_arena.data() + record.content_offset,
+                                                  record.content_length));
+        if (found != shared_bodies.end() && --found->second.refs > 0) {
+            return;
+        }
+        if (found != shared_bodies.end()) {
+            shared_bodies.erase(found);
+        }
+    }
+    content_garbage += record.content_length;
+}
+
+void MessageStore::compact_arena() {
+    std::string compacted;
+    compacted.reserve(content_arena.size() - content_garbage);
+    std::unordered_map<uint64_t, uint64_t> moved;     // Old -> new offset of shared bodies
+    for (Record& stored : records) {
+        if (stored.flags & EXTRA_SHARED_BODY) {
+            auto [it, first] = moved.emplace(stored.content_offset, compacted.size());
+            if (first) {
+                compacted.append(content_arena, stored.content_offset, stored.content_length);
+            }
+            stored.content_offset = it->second;
+            continue;
+        }
+        size_t offset = compacted.size();
+        compacted.append(content_arena, stored.content_offset, stored.content_length);
+        stored.content_offset = offset;
+    }
+    for (auto& [hash, body] : shared_bodies) {
+        body.offset = moved[body.offset];
+    }
+    content_arena.swap(compacted);
+    content_garbage = 0;
+}
+
+void MessageStore::clear() {
+    records.clear();
+    content_arena.clear();
+    content_garbage = 0;
+    participants.clear();
+    participant_ids.clear();
+    by_receiver.clear();
+    by_sender.clear();
+    by_id.clear();
+    by_text_id.clear();
+    text_ids.clear();
+    replies.clear();
+    origins.clear();
+    attachments.clear();
+    shared_bodies.clear();
+}
+
+// ================== Lookup ==================
+bool MessageStore::slot_of(const std::wstring& id, size_t& slot) const {
+    MessageId packed;
+    if (pack_id(id, packed)) {
+        auto it = by_id.find(packed);
+        if (it == by_id.end()) {
+            return false;
+        }
+        slot = it->second;
+        return true;
+    }
+    auto it = by_text_id.find(id);
+    if (it == by_text_id.end()) {
+        return false;
+    }
+    slot = it->second;
+    return true;
+}
+
+bool MessageStore::get(const std::wstring& id, ChatMessage& out) const {
+    size_t slot;
+    if (!slot_of(id, slot)) {
+        return false;
+    }
+    out = at(slot);
+    return true;
+}
+
+std::wstring MessageStore::id_at(size_t slot) const {
+    const Record& record = records[slot];
+    return (record.flags & EXTRA_TEXT_ID) ? text_ids.at(slot) : record.id.to_wstring();
+}
+
+ChatMessage MessageStore::at(size_t slot) const {
+    const Record& record = records[slot];
+    ChatMessage msg;
+    msg.id = id_at(slot);
+    msg.sender = participants[record.sender];
+    msg.receiver = participants[record.receiver];
+    msg.content = utf8_to_wide(content_arena.substr(record.content_offset, record.content_length));
+    msg.timestamp = record.timestamp;
+    msg.edit_expiry_time = record.edit_expiry_time;
+    msg.delivered_time = record.delivered_time;
+    msg.seen_time = record.seen_time;
+
+    msg.is_read = record.flags & FLAG_READ;
+    msg.is_editable = record.flags & FLAG_EDITABLE;
+    msg.is_deleted = record.flags & FLAG_DELETED;
+    msg.deleted_by_sender = record.flags & FLAG_DELETED_BY_SENDER;
+    msg.deleted_by_receiver = record.flags & FLAG_DELETED_BY_RECEIVER;
+    msg.is_delivered = record.flags & FLAG_DELIVERED;
+    msg.is_seen = record.flags & FLAG_SEEN;
+    msg.is_forwarded = record.flags & FLAG_FORWARDED;
+    msg.has_attachment = record.flags & FLAG_HAS_ATTACHMENT;
+    msg.is_queued = record.flags & FLAG_QUEUED;
+
+    if (record.flags & EXTRA_REPLY) {
+        const Reply& reply = replies.at(slot);
+        msg.replied_to_id = reply.id;
+        msg.replied_to_content = reply.content;
+        msg.replied_to_sender = reply.sender;
+    }
+    if (record.flags & EXTRA_ORIGIN) {
+        msg.original_sender = participants[origins.at(slot)];
+    }
+    if (record.flags & EXTRA_FILE) {
+        const Attachment& attachment = attachments.at(slot);
+        msg.file_path = attachment.path;
+        msg.file_name = attachment.name;
+    }
+    return msg;
+}
+
+const std::vector<size_t>& MessageStore::slots_of(const std::vector<std::vector<size_t>>& index,
+                                                  const std::wstring& user) const {
+    auto it = participant_ids.find(user);
+    return it == participant_ids.end() ? no_slots : index[it->second];
+}
+
+const std::vector<size_t>& MessageStore::received_by(const std::wstring& user) const {
+    return slots_of(by_receiver, user);
+}
+
+const std::vector<size_t>& MessageStore::sent_by(const std::wstring& user) const {
+    return slots_of(by_sender, user);
+}
+
+// ================== Memory ==================
+static size_t wide_bytes(const std::wstring& text) {
+    return text.capacity() > std::wstring().capacity() ? (text.capacity() + 1) * sizeof(wchar_t) : 0;
+}
+
+size_t MessageStore::memory_usage() const {
+    // Hash nodes are counted as key + value + next pointer + cached hash; buckets as one pointer each
+    const size_t node_overhead = 2 * sizeof(void*);
+    auto table_bytes = [&](size_t size, size_t buckets, size_t entry) {
+        return size * (entry + node_overhead) + buckets * sizeof(void*);
+    };
+
+    size_t bytes = records.size() * sizeof(Record) + content_arena.capacity();
+    for (const std::wstring& name : participants) {
+        bytes += sizeof(name) + wide_bytes(name);
+    }
+    bytes += table_bytes(participant_ids.size(), participant_ids.bucket_count(),
+                         sizeof(std::wstring) + sizeof(uint32_t));
+    for (const auto& slots : by_receiver) bytes += sizeof(slots) + slots.capacity() * sizeof(size_t);
+    for (const auto& slots : by_sender) bytes += sizeof(slots) + slots.capacity() * sizeof(size_t);
+
+    bytes += table_bytes(by_id.size(), by_id.bucket_count(), sizeof(MessageId) + sizeof(size_t));
+    bytes += table_bytes(by_text_id.size(), by_text_id.bucket_count(), sizeof(std::wstring) + sizeof(size_t));
+    for (const auto& [id, slot] : by_text_id) bytes += wide_bytes(id);
+
+    bytes += table_bytes(text_ids.size(), text_ids.bucket_count(), sizeof(size_t) + sizeof(std::wstring));
+    for (const auto& [slot, id] : text_ids) bytes += wide_bytes(id);
+    bytes += table_bytes(replies.size(), replies.bucket_count(), sizeof(size_t) + sizeof(Reply));
+    for (const auto& [slot, reply] : replies) {
+        bytes += wide_bytes(reply.id) + wide_bytes(reply.content) + wide_bytes(reply.sender);
+    }
+    bytes += table_bytes(origins.size(), origins.bucket_count(), sizeof(size_t) + sizeof(uint32_t));
+    bytes += table_bytes(attachments.size(), attachments.bucket_count(), sizeof(size_t) + sizeof(Attachment));
+    for (const auto& [slot, attachment] : attachments) {
+        bytes += wide_bytes(attachment.path) + wide_bytes(attachment.name);
+    }
+    bytes += table_bytes(shared_bodies.size(), shared_bodies.bucket_count(), sizeof(uint64_t) + sizeof(SharedBody));
+    return bytes;
+}
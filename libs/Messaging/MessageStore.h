@@ -0,0 +1,172 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include "MessageId.h"
+
+struct ChatMessage {
+    std::wstring id;
+    std::wstring sender;
+    std::wstring receiver;
+    std::wstring content;
+    std::wstring original_sender;
+    std::wstring replied_to_id;
+    std::wstring replied_to_content;
+    std::wstring replied_to_sender;
+    time_t edit_expiry_time;
+    time_t timestamp;
+    bool is_read = false;
+    bool is_editable = true;
+    bool is_deleted = false;
+    bool deleted_by_sender = false;
+    bool deleted_by_receiver = false;
+    bool is_delivered = false;
+    bool is_seen = false;
+    time_t delivered_time = 0;
+    time_t seen_time = 0;
+    bool is_forwarded = false;
+    std::wstring file_path;
+    std::wstring file_name;
+    bool has_attachment = false;
+    bool is_queued = false;         // In the local outbox, not yet in the database
+
+    std::wstring get_formatted_time() const {
+        std::tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &timestamp);
+#else
+        localtime_r(&timestamp, &tm);
+#endif
+        std::wstringstream wss;
+        wss << std::put_time(&tm, L"%Y-%m-%d %H:%M:%S");
+        return wss.str();
+    }
+};
+
+// Compact message storage with an id -> slot index and per-receiver / per-sender slot lists.
+// ChatMessage stays the exchange type, but it is not what is stored: each message is a
+// fixed record with interned participants, packed status bits and UTF-8 content in one arena, and
+// the fields most messages leave empty (reply, forward origin, attachment, ids that are
+// not MessageIds) live in sparse side tables keyed by slot. Forwards of the same text
+// share one copy of it in the arena.
+// Messages are only ever appended (deletion is a flag), so slots never change.
+class MessageStore {
+public:
+    // Status bits of a stored message
+    enum : uint16_t {
+        FLAG_READ = 1 << 0,
+        FLAG_EDITABLE = 1 << 1,
+        FLAG_DELETED = 1 << 2,
+        FLAG_DELETED_BY_SENDER = 1 << 3,
+        FLAG_DELETED_BY_RECEIVER = 1 << 4,
+        FLAG_DELIVERED = 1 << 5,
+        FLAG_SEEN = 1 << 6,
+        FLAG_FORWARDED = 1 << 7,
+        FLAG_HAS_ATTACHMENT = 1 << 8,
+        FLAG_QUEUED = 1 << 9
+    };
+
+    // False if a message with the same id is already stored
+    bool add(const ChatMessage& msg);
+
+    bool slot_of(const std::wstring& id, size_t& slot) const;
+    bool get(const std::wstring& id, ChatMessage& out) const;
+    ChatMessage at(size_t slot) const;                 // Materializes a copy
+    // Rewrites the mutable fields; id, sender and receiver must not change
+    void replace(size_t slot, const ChatMessage& msg);
+
+    // Receipts only touch status bits and times, never the content arena
+    void mark_delivered(size_t slot, time_t when);
+    void mark_seen(size_t slot, time_t when);      // Seen implies read
+
+    uint16_t flags(size_t slot) const { return records[slot].flags & STATUS_MASK; }
+    std::wstring id_at(size_t slot) const;
+    const std::wstring& sender_at(size_t slot) const { return participants[records[slot].sender]; }
+    const std::wstring& receiver_at(size_t slot) const { return participants[records[slot].receiver]; }
+
+    // Slots in insertion order; resolve with at()
+    const std::vector<size_t>& received_by(const std::wstring& user) const;
+    const std::vector<size_t>& sent_by(const std::wstring& user) const;
+
+    size_t size() const { return records.size(); }
+    bool empty() const { return records.empty(); }
+    void clear();
+
+    size_t memory_usage() const;   // Approximate bytes held by records, indexes and side tables
+
+private:
+    // Side-table presence bits, never exposed through flags()
+    enum : uint16_t {
+        EXTRA_SHARED_BODY = 1 << 11,    // Content is a range of shared_bodies
+        EXTRA_TEXT_ID = 1 << 12,
+        EXTRA_REPLY = 1 << 13,
+        EXTRA_ORIGIN = 1 << 14,
+        EXTRA_FILE = 1 << 15
+    };
+    static const uint16_t STATUS_MASK = 0x07FF;
+
+    struct Record {
+        MessageId id;               // Zero when the id is kept in text_ids
+        uint32_t sender;            // Index into participants
+        uint32_t receiver;
+        uint16_t flags;
+        uint32_t content_length;
+        uint64_t content_offset;    // UTF-8 bytes in content_arena
+        time_t timestamp;
+        time_t edit_expiry_time;
+        time_t delivered_time;
+        time_t seen_time;
+    };
+
+    struct Reply {
+        std::wstring id;
+        std::wstring content;
+        std::wstring sender;
+    };
+
+    struct Attachment {
+        std::wstring path;
+        std::wstring name;
+    };
+
+    struct SharedBody {
+        uint64_t offset;
+        uint32_t length;
+        uint32_t refs;              // Records pointing at it
+    };
+
+    std::deque<Record> records;
+    std::string content_arena;      // Content of every record, back to back
+    size_t content_garbage = 0;     // Arena bytes left behind by edits
+
+    // Participant names are stored once; records and indexes refer to them by number
+    std::vector<std::wstring> participants;
+    std::unordered_map<std::wstring, uint32_t> participant_ids;
+    std::vector<std::vector<size_t>> by_receiver;   // By participant
+    std::vector<std::vector<size_t>> by_sender;
+
+    std::unordered_map<MessageId, size_t> by_id;
+    std::unordered_map<std::wstring, size_t> by_text_id;   // Ids that do not parse as MessageId
+
+    // ============ Side tables (slot -> rare fields) ============
+    std::unordered_map<size_t, std::wstring> text_ids;
+    std::unordered_map<size_t, Reply> replies;
+    std::unordered_map<size_t, uint32_t> origins;          // Original sender of a forward
+    std::unordered_map<size_t, Attachment> attachments;
+    std::unordered_map<uint64_t, SharedBody> shared_bodies;    // Text hash -> arena range, forwards only
+
+    static const std::vector<size_t> no_slots;
+
+    uint32_t intern(const std::wstring& name);
+    const std::vector<size_t>& slots_of(const std::vector<std::vector<size_t>>& index,
+                                        const std::wstring& user) const;
+    void store_fields(size_t slot, Record& record, const ChatMessage& msg);
+    void store_content(Record& record, const std::wstring& content);
+    void release_content(Record& record);
+    void compact_arena();
+};
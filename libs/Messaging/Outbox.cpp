@@ -0,0 +1,323 @@
+#include "Outbox.h"
+#include "Utf8.h"
+#include <map>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static bool sync_file(std::FILE* file) {
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+Outbox::Outbox(const std::string& path, DeliverFn deliver)
+    : Outbox(path, std::move(deliver), Options()) {}
+
+Outbox::Outbox(const std::string& path, DeliverFn deliver, Options options)
+    : path(path), deliver(std::move(deliver)), options(options) {}
+
+Outbox::~Outbox() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_cv.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+// ================== Encoding ==================
+static void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+static void put_u64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+static void put_text(std::string& out, const std::wstring& text) {
+    std::string utf8 = wide_to_utf8(text);
+    put_u32(out, static_cast<uint32_t>(utf8.size()));
+    out += utf8;
+}
+
+// Bounds-checked reader over one record
+struct Reader {
+    const std::string& data;
+    size_t pos;
+
+    bool u32(uint32_t& value) {
+        if (data.size() - pos < 4) return false;
+        value = 0;
+        for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos++])) << (8 * i);
+        return true;
+    }
+    bool u64(uint64_t& value) {
+        if (data.size() - pos < 8) return false;
+        value = 0;
+        for (int i = 0; i < 8; i++) value |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos++])) << (8 * i);
+        return true;
+    }
+    bool text(std::wstring& value) {
+        uint32_t length;
+        if (!u32(length) || data.size() - pos < length) return false;
+        value = utf8_to_wide(data.substr(pos, length));
+        pos += length;
+        return true;
+    }
+};
+
+static uint32_t checksum(const char* data, size_t size) {
+    // FNV-1a: enough to tell a torn write from a complete record
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+void Outbox::encode(std::string& out, uint8_t type, const std::string& payload) {
+    std::string body(1, static_cast<char>(type));
+    body += payload;
+    put_u32(out, static_cast<uint32_t>(body.size()));
+    put_u32(out, checksum(body.data(), body.size()));
+    out += body;
+}
+
+std::string Outbox::encode_entry(const OutboxEntry& entry) {
+    std::string payload;
+    put_u64(payload, entry.sequence);
+    put_u64(payload, static_cast<uint64_t>(entry.timestamp));
+    put_text(payload, entry.id);
+    put_text(payload, entry.sender);
+    put_text(payload, entry.receiver);
+    put_text(payload, entry.content);
+    put_text(payload, entry.file_path);
+    return payload;
+}
+
+bool Outbox::decode_entry(const std::string& payload, OutboxEntry& entry) {
+    Reader reader{payload, 0};
+    uint64_t timestamp;
+    if (!reader.u64(entry.sequence) || !reader.u64(timestamp) || !reader.text(entry.id) ||
+        !reader.text(entry.sender) || !reader.text(entry.receiver) || !reader.text(entry.content) ||
+        !reader.text(entry.file_path)) {
+        return false;
+    }
+    entry.timestamp = static_cast<time_t>(timestamp);
+    return true;
+}
+
+// ================== Open and Replay ==================
+bool Outbox::open(std::vector<OutboxEntry>& pending) {
+    pending.clear();
+    std::string data;
+    if (std::FILE* in = std::fopen(path.c_str(), "rb")) {
+        char chunk[1 << 16];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), in)) > 0) {
+            data.append(chunk, read);
+        }
+        std::fclose(in);
+    }
+
+    std::map<uint64_t, OutboxEntry> unacked;
+    uint64_t last_sequence = 0;
+    Reader reader{data, 0};
+    size_t good_end = 0;
+    while (reader.pos < data.size()) {
+        uint32_t length, sum;
+        if (!reader.u32(length) || !reader.u32(sum) || length == 0 || data.size() - reader.pos < length ||
+            checksum(data.data() + reader.pos, length) != sum) {
+            break;      // Torn or corrupt tail
+        }
+        uint8_t type = static_cast<uint8_t>(data[reader.pos]);
+        std::string payload = data.substr(reader.pos + 1, length - 1);
+        reader.pos += length;
+
+        if (type == RECORD_ENTRY) {
+            OutboxEntry entry;
+            if (!decode_entry(payload, entry)) break;
+            last_sequence = std::max(last_sequence, entry.sequence);
+            unacked[entry.sequence] = std::move(entry);
+        } else if (type == RECORD_ACK) {
+            Reader ack{payload, 0};
+            uint64_t sequence;
+            if (!ack.u64(sequence)) break;
+            unacked.erase(sequence);
+        }
+        good_end = reader.pos;
+    }
+
+    std::error_code error;
+    if (good_end < data.size()) {
+        std::filesystem::resize_file(path, good_end, error);
+        if (error) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        return false;
+    }
+    file_bytes = good_end;
+    next_sequence = last_sequence + 1;
+    for (auto& [sequence, entry] : unacked) {
+        pending.push_back(entry);
+        queue.push_back(std::move(entry));
+    }
+    return true;
+}
+
+void Outbox::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!flusher.joinable() && !stopping) {
+        flusher = std::thread(&Outbox::run, this);
+    }
+}
+
+// ================== Append (group commit) ==================
+bool Outbox::append(OutboxEntry& entry) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!file || broken) {
+        return false;
+    }
+    entry.sequence = next_sequence++;
+    encode(buffer, RECORD_ENTRY, encode_entry(entry));
+    uint64_t ticket = ++buffered_tickets;
+    // Another caller's sync can put this entry on disk before it is queued; until it is,
+    // the flusher must not take an empty queue for a fully acknowledged journal
+    unqueued++;
+
+    // The first waiter without a sync in flight writes for everyone buffered so far
+    while (synced_tickets < ticket && !broken) {
+        if (!syncing) {
+            write_buffer(lock);
+        } else {
+            synced_cv.wait(lock);
+        }
+    }
+    unqueued--;
+    if (synced_tickets < ticket) {
+        return false;
+    }
+
+    counters.appended++;
+    queue.push_back(entry);
+    work_cv.notify_one();
+    return true;
+}
+
+bool Outbox::write_buffer(std::unique_lock<std::mutex>& lock) {
+    std::string out;
+    out.swap(buffer);
+    uint64_t target = buffered_tickets;
+    // Acknowledgements alone need no fsync: losing one only means a harmless redelivery
+    bool sync = options.sync && target > synced_tickets;
+    syncing = true;
+
+    lock.unlock();
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size() && std::fflush(file) == 0 &&
+              (!sync || sync_file(file));
+    lock.lock();
+
+    syncing = false;
+    if (ok) {
+        synced_tickets = target;
+        file_bytes += out.size();
+        counters.syncs += sync;
+    } else {
+        broken = true;
+    }
+    synced_cv.notify_all();
+    return ok;
+}
+
+void Outbox::maybe_compact() {
+    // Everything written is acknowledged: start the journal over
+    if (!queue.empty() || unqueued > 0 || !buffer.empty() || syncing || file_bytes < options.compact_bytes) {
+        return;
+    }
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        broken = true;
+        return;
+    }
+    file_bytes = 0;
+}
+
+// ================== Delivery ==================
+void Outbox::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping) {
+            break;
+        }
+
+        OutboxEntry entry = queue.front();
+        lock.unlock();
+        bool ok = deliver(entry);
+        lock.lock();
+
+        if (!ok) {
+            counters.failed_deliveries++;
+            // Still the front: append() only adds at the back
+            if (++front_failures >= options.max_attempts && queue.size() > 1) {
+                queue.push_back(std::move(queue.front()));
+                queue.pop_front();
+                front_failures = 0;
+                counters.deferred++;
+            }
+            work_cv.wait_for(lock, options.retry_delay, [this] { return stopping; });
+            continue;
+        }
+        front_failures = 0;
+        queue.pop_front();
+        counters.delivered++;
+        std::string payload;
+        put_u64(payload, entry.sequence);
+        encode(buffer, RECORD_ACK, payload);
+
+        if (queue.empty()) {
+            if (!syncing && !broken) {
+                write_buffer(lock);
+            }
+            if (!broken) {
+                maybe_compact();
+            }
+            drained_cv.notify_all();
+        }
+    }
+
+    // Keep the acknowledgements gathered so far; they save redeliveries after restart
+    if (!syncing && !broken && !buffer.empty() && file) {
+        write_buffer(lock);
+    }
+}
+
+bool Outbox::wait_drained(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return drained_cv.wait_for(lock, timeout, [this] { return queue.empty(); });
+}
+
+Outbox::Stats Outbox::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = counters;
+    result.pending = queue.size();
+    return result;
+}
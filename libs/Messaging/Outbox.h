@@ -0,0 +1,115 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <condition_variable>
+
+// One outgoing message as recorded in the journal
+struct OutboxEntry {
+    uint64_t sequence = 0;      // Journal position, assigned by append()
+    std::wstring id;            // Client message id; the database write is idempotent on it
+    std::wstring sender;
+    std::wstring receiver;
+    std::wstring content;
+    std::wstring file_path;
+    time_t timestamp = 0;
+};
+
+// Append-only local journal between send() and the database.
+//
+// append() returns once the entry is on disk. Concurrent appends share one fsync
+// (group commit): whichever caller finds no sync in progress writes everything
+// buffered so far, and the others wait for it. A background thread then delivers
+// entries to the database in append order, retrying failures, and records an
+// acknowledgement for each. An entry that still fails after max_attempts tries
+// is moved behind the others so it cannot hold up the queue; from then on the
+// order is best-effort, as later entries may be delivered before it. On open()
+// every entry without an acknowledgement is handed back for replay, so delivery
+// is at-least-once: DeliverFn must be idempotent on the entry id.
+//
+// Record layout: [u32 length][u32 checksum][u8 type][payload]. A torn or corrupt
+// tail (crash in the middle of a write) is cut off on open().
+class Outbox {
+public:
+    // Writes one entry to the database; false leaves it queued and retries later
+    using DeliverFn = std::function<bool(const OutboxEntry&)>;
+
+    struct Options {
+        bool sync = true;                                       // fsync each group commit
+        std::chrono::milliseconds retry_delay{200};             // After a failed delivery
+        size_t compact_bytes = 1 << 20;                         // Truncate once drained and this large
+        int max_attempts = 5;                                   // Failures in a row before an entry goes to the back
+    };
+
+    struct Stats {
+        uint64_t appended = 0;
+        uint64_t delivered = 0;
+        uint64_t failed_deliveries = 0;
+        uint64_t deferred = 0;      // Times an entry was moved to the back after max_attempts failures
+        uint64_t syncs = 0;         // Group commits; appended / syncs = entries per fsync
+        size_t pending = 0;
+    };
+
+    Outbox(const std::string& path, DeliverFn deliver);
+    Outbox(const std::string& path, DeliverFn deliver, Options options);
+    ~Outbox();      // Stops the flusher; undelivered entries stay in the journal
+
+    Outbox(const Outbox&) = delete;
+    Outbox& operator=(const Outbox&) = delete;
+
+    // Opens (or creates) the journal; pending receives unacknowledged entries, oldest first.
+    // They are queued for delivery once start() is called.
+    bool open(std::vector<OutboxEntry>& pending);
+    void start();
+
+    // Durable once it returns true; false if the journal cannot be written
+    bool append(OutboxEntry& entry);
+    // Blocks until everything appended so far is delivered or timeout passes
+    bool wait_drained(std::chrono::milliseconds timeout);
+    Stats stats() const;
+
+private:
+    enum : uint8_t {
+        RECORD_ENTRY = 1,
+        RECORD_ACK = 2
+    };
+
+    std::string path;
+    DeliverFn deliver;
+    Options options;
+    std::FILE* file = nullptr;
+    size_t file_bytes = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable synced_cv;      // Group commit finished
+    std::condition_variable work_cv;        // Flusher: new entries or stop
+    std::condition_variable drained_cv;
+
+    std::string buffer;                     // Encoded records not yet written
+    uint64_t buffered_tickets = 0;          // Entries encoded into buffer so far
+    uint64_t synced_tickets = 0;            // Entries known to be on disk
+    bool syncing = false;
+    bool broken = false;                    // A write failed; appends are refused
+
+    std::deque<OutboxEntry> queue;          // Durable, waiting for delivery
+    size_t unqueued = 0;                    // Encoded by append() but not in queue yet; blocks compaction
+    int front_failures = 0;                 // Failed deliveries in a row of queue.front()
+    uint64_t next_sequence = 1;
+    bool stopping = false;
+    std::thread flusher;
+    Stats counters;
+
+    void run();
+    bool write_buffer(std::unique_lock<std::mutex>& lock);     // Call with mutex held, no sync in flight
+    void maybe_compact();                                       // Call with mutex held
+    static void encode(std::string& out, uint8_t type, const std::string& payload);
+    static std::string encode_entry(const OutboxEntry& entry);
+    static bool decode_entry(const std::string& payload, OutboxEntry& entry);
+};
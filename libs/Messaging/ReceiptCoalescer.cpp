@@ -0,0 +1,110 @@
+#include "ReceiptCoalescer.h"
+#include "Utf8.h"
+#include <algorithm>
+
+ReceiptCoalescer::ReceiptCoalescer(FlushFn flush_fn, std::chrono::milliseconds window)
+    : flush_fn(std::move(flush_fn)), window(window) {}
+
+ReceiptCoalescer::~ReceiptCoalescer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    flush();
+}
+
+void ReceiptCoalescer::add(const std::wstring& sender, const std::wstring& receiver,
+                           Receipt receipt, int message_id) {
+    ReceiptWatermark mark;
+    mark.sender = wide_to_utf8(sender);
+    mark.receiver = wide_to_utf8(receiver);
+    (receipt == Receipt::Seen ? mark.seenUpTo : mark.deliveredUpTo) = message_id;
+
+    bool was_idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters.receipts++;
+        was_idle = pending.empty();
+        merge(mark);
+        if (!flusher.joinable() && !stopping) {
+            flusher = std::thread(&ReceiptCoalescer::run, this);
+        }
+    }
+    if (was_idle) {
+        wake.notify_one();
+    }
+}
+
+void ReceiptCoalescer::flush() {
+    std::vector<ReceiptWatermark> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch = take_pending();
+    }
+    write(std::move(batch));
+}
+
+ReceiptCoalescer::Stats ReceiptCoalescer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+// ================== Background Flush ==================
+void ReceiptCoalescer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (stopping) {
+            return;     // The destructor writes the rest
+        }
+
+        // Let the first receipt's neighbours arrive before writing
+        wake.wait_for(lock, window, [this] { return stopping; });
+        std::vector<ReceiptWatermark> batch = take_pending();
+        lock.unlock();
+        write(std::move(batch));
+        lock.lock();
+    }
+}
+
+void ReceiptCoalescer::write(std::vector<ReceiptWatermark> batch) {
+    if (batch.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> write_lock(write_mutex);
+    bool ok = flush_fn(batch);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ok) {
+        counters.batches++;
+        counters.watermarks += batch.size();
+        return;
+    }
+    counters.failed_batches++;
+    for (const ReceiptWatermark& mark : batch) {
+        merge(mark);
+    }
+}
+
+std::vector<ReceiptWatermark> ReceiptCoalescer::take_pending() {
+    std::vector<ReceiptWatermark> batch;
+    batch.reserve(pending.size());
+    for (auto& entry : pending) {
+        batch.push_back(std::move(entry.second));
+    }
+    pending.clear();
+    return batch;
+}
+
+void ReceiptCoalescer::merge(const ReceiptWatermark& mark) {
+    auto result = pending.try_emplace({mark.sender, mark.receiver}, mark);
+    if (!result.second) {
+        ReceiptWatermark& current = result.first->second;
+        current.deliveredUpTo = std::max(current.deliveredUpTo, mark.deliveredUpTo);
+        current.seenUpTo = std::max(current.seenUpTo, mark.seenUpTo);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+#include "Database.h"
+#include "MessageCache.h"
+
+// Buffers delivered/seen receipts and writes them in batches. Receipts of one
+// conversation (sender -> receiver) collapse into a single "up to id" watermark,
+// so scrolling through a hundred messages costs one row in the next batch instead
+// of a hundred writes. The in-memory state is updated by the caller right away;
+// only persistence is deferred, by at most one window.
+class ReceiptCoalescer {
+public:
+    // Writes one batch; returning false puts the batch back for the next window
+    using FlushFn = std::function<bool(const std::vector<ReceiptWatermark>&)>;
+
+    struct Stats {
+        uint64_t receipts = 0;          // add() calls
+        uint64_t batches = 0;           // Successful flush_fn calls
+        uint64_t watermarks = 0;        // Conversations written across all batches
+        uint64_t failed_batches = 0;
+    };
+
+    explicit ReceiptCoalescer(FlushFn flush_fn,
+                              std::chrono::milliseconds window = std::chrono::milliseconds(100));
+    ~ReceiptCoalescer();    // Writes whatever is still pending; a batch that fails here is dropped
+
+    ReceiptCoalescer(const ReceiptCoalescer&) = delete;
+    ReceiptCoalescer& operator=(const ReceiptCoalescer&) = delete;
+
+    // message_id is the database row id; the background flusher starts on first use
+    void add(const std::wstring& sender, const std::wstring& receiver, Receipt receipt, int message_id);
+    void flush();           // Writes pending watermarks now, on the calling thread
+    Stats stats() const;
+
+private:
+    FlushFn flush_fn;
+    std::chrono::milliseconds window;
+
+    std::map<std::pair<std::string, std::string>, ReceiptWatermark> pending;   // By (sender, receiver)
+    Stats counters;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread flusher;
+    bool stopping = false;
+
+    std::mutex write_mutex;     // One batch in flight at a time
+
+    void run();
+    void write(std::vector<ReceiptWatermark> batch);
+    std::vector<ReceiptWatermark> take_pending();                   // Call with mutex held
+    void merge(const ReceiptWatermark& mark);                       // Call with mutex held
+};
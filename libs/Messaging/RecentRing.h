@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Fixed-capacity ring of the newest entries. Storage grows with use up to the
+// capacity, so rings for quiet users stay small. Not thread-safe.
+template <typename T>
+class RecentRing {
+public:
+    explicit RecentRing(size_t capacity = 64) : capacity(capacity) {}
+
+    // Returns true if the oldest entry was evicted to make room
+    bool push(const T& value) {
+        if (entries.size() < capacity) {
+            entries.push_back(value);
+            return false;
+        }
+        entries[head] = value;
+        head = (head + 1) % capacity;
+        return true;
+    }
+
+    // Removes one occurrence; O(size). Returns false if absent.
+    bool erase(const T& value) {
+        std::vector<T> ordered = oldest_first();
+        for (size_t i = 0; i < ordered.size(); i++) {
+            if (ordered[i] == value) {
+                ordered.erase(ordered.begin() + static_cast<std::ptrdiff_t>(i));
+                entries.swap(ordered);
+                head = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Up to limit entries, newest first
+    void newest(size_t limit, std::vector<T>& out) const {
+        out.clear();
+        for (size_t i = 0; i < entries.size() && out.size() < limit; i++) {
+            out.push_back(entries[(head + entries.size() - 1 - i) % entries.size()]);
+        }
+    }
+
+    size_t size() const { return entries.size(); }
+
+private:
+    size_t capacity;
+    std::vector<T> entries;
+    size_t head = 0;        // Oldest entry once the ring is full
+
+    std::vector<T> oldest_first() const {
+        std::vector<T> ordered;
+        ordered.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            ordered.push_back(entries[(head + i) % entries.size()]);
+        }
+        return ordered;
+    }
+};
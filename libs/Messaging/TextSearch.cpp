@@ -0,0 +1,81 @@
+#include "TextSearch.h"
+#include "Utf8.h"
+#include <cwctype>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTSEARCH_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int countTrailingZeros(uint32_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+std::string fold_for_search(const std::wstring& text) {
+    std::wstring folded(text);
+    for (wchar_t& ch : folded) {
+        // ASCII directly; towlower goes through the locale
+        if (ch >= L'A' && ch <= L'Z') {
+            ch = static_cast<wchar_t>(ch + (L'a' - L'A'));
+        } else if (static_cast<uint32_t>(ch) >= 0x80) {
+            ch = static_cast<wchar_t>(std::towlower(static_cast<wint_t>(ch)));
+        }
+    }
+    return wide_to_utf8(folded);
+}
+
+// A candidate already matches the needle's first and last byte; compare the middle
+static bool middle_matches(const char* candidate, const char* needle, size_t needle_length) {
+    return needle_length <= 2 || std::memcmp(candidate + 1, needle + 1, needle_length - 2) == 0;
+}
+
+bool contains_folded(const char* haystack, size_t haystack_length,
+                     const char* needle, size_t needle_length) {
+    if (needle_length == 0) {
+        return true;
+    }
+    if (needle_length > haystack_length) {
+        return false;
+    }
+
+    size_t last_start = haystack_length - needle_length;   // Last valid start position
+    size_t i = 0;
+
+#ifdef TEXTSEARCH_USE_SSE2
+    // 16 start positions per step: compare the first and the last needle byte at once
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_length - 1]);
+    for (; i + 15 <= last_start; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needle_length - 1));
+        uint32_t mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask != 0) {
+            if (middle_matches(haystack + i + countTrailingZeros(mask), needle, needle_length)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i <= last_start; i++) {
+        if (haystack[i] == needle[0] && haystack[i + needle_length - 1] == needle[needle_length - 1] &&
+            middle_matches(haystack + i, needle, needle_length)) {
+            return true;
+        }
+    }
+    return false;
+}
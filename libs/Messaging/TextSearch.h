@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// Case-insensitive substring search for the message cache.
+// Search text is folded once, when a message is cached or edited, and kept as UTF-8:
+// half the bytes of wchar_t text for Persian, a quarter for ASCII, and 16 positions
+// per SSE2 compare. UTF-8 is self-synchronizing, so a byte match of a folded needle
+// is always a match of whole characters.
+
+// Lower-cases with std::towlower (same rules as the old per-character compare) and encodes as UTF-8
+std::string fold_for_search(const std::wstring& text);
+
+// True if needle occurs in haystack; both must come from fold_for_search.
+// Uses an SSE2 first/last-byte filter on x86 and a scalar scan elsewhere.
+bool contains_folded(const char* haystack, size_t haystack_length,
+                     const char* needle, size_t needle_length);
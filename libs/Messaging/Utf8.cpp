@@ -0,0 +1,259 @@
+#include "Utf8.h"
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const char32_t REPLACEMENT = 0xFFFD;
+static const bool WIDE_IS_UTF16 = sizeof(wchar_t) == 2;
+
+// ================== ASCII Runs ==================
+// Copies the leading ASCII bytes of s into out; returns how many were copied
+static size_t widen_ascii(const unsigned char* s, size_t n, wchar_t* out) {
+    size_t i = 0;
+#ifdef UTF8_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            break;  // A byte >= 0x80 somewhere in this block
+        }
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);    // 8 x uint16
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        if (WIDE_IS_UTF16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), high);
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), _mm_unpackhi_epi16(high, zero));
+        }
+    }
+#endif
+    for (; i < n && s[i] < 0x80; i++) {
+        out[i] = static_cast<wchar_t>(s[i]);
+    }
+    return i;
+}
+
+// Copies the leading ASCII code units of w into out; returns how many were copied
+static size_t narrow_ascii(const wchar_t* w, size_t n, unsigned char* out) {
+    size_t i = 0;
+#ifdef UTF8_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    if (WIDE_IS_UTF16) {
+        const __m128i nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+        for (; i + 8 <= n; i += 8) {
+            __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+            __m128i high = _mm_cmpeq_epi16(_mm_and_si128(units, nonAscii), zero);
+            if (_mm_movemask_epi8(high) != 0xFFFF) {
+                break;
+            }
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(units, units));
+        }
+    } else {
+        const __m128i nonAscii = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+        for (; i + 8 <= n; i += 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i + 4));
+            __m128i high = _mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(a, b), nonAscii), zero);
+            if (_mm_movemask_epi8(high) != 0xFFFF) {
+                break;
+            }
+            __m128i units16 = _mm_packs_epi32(a, b);    // Values < 0x80, so no saturation
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(units16, units16));
+        }
+    }
+#endif
+    for (; i < n && static_cast<uint32_t>(w[i]) < 0x80; i++) {
+        out[i] = static_cast<unsigned char>(w[i]);
+    }
+    return i;
+}
+
+// ================== Scalar Sequences ==================
+// Decodes the sequence starting at a non-ASCII lead byte into cp and sets consumed.
+// On malformed input returns false, cp is U+FFFD and consumed covers the maximal invalid subpart.
+static bool decode_sequence(const unsigned char* s, size_t available, char32_t& cp, size_t& consumed) {
+    unsigned char lead = s[0];
+    unsigned char low = 0x80, high = 0xBF;    // Allowed range of the second byte
+    size_t length;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        cp = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        cp = lead & 0x0F;
+        if (lead == 0xE0) low = 0xA0;         // Overlong
+        if (lead == 0xED) high = 0x9F;        // Surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        cp = lead & 0x07;
+        if (lead == 0xF0) low = 0x90;         // Overlong
+        if (lead == 0xF4) high = 0x8F;        // Above U+10FFFF
+    } else {
+        cp = REPLACEMENT;
+        consumed = 1;
+        return false;
+    }
+
+    for (size_t k = 1; k < length; k++) {
+        if (k >= available || s[k] < low || s[k] > high) {
+            cp = REPLACEMENT;
+            consumed = k;
+            return false;
+        }
+        cp = (cp << 6) | (s[k] & 0x3F);
+        low = 0x80;
+        high = 0xBF;
+    }
+    consumed = length;
+    return true;
+}
+
+static size_t put_wide(wchar_t* out, char32_t cp) {
+    if (WIDE_IS_UTF16 && cp > 0xFFFF) {
+        cp -= 0x10000;
+        out[0] = static_cast<wchar_t>(0xD800 + (cp >> 10));
+        out[1] = static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+        return 2;
+    }
+    out[0] = static_cast<wchar_t>(cp);
+    return 1;
+}
+
+static size_t put_utf8(unsigned char* out, char32_t cp) {
+    if (cp < 0x80) {
+        out[0] = static_cast<unsigned char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<unsigned char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<unsigned char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<unsigned char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// ================== Public API ==================
+std::wstring utf8_to_wide(const std::string& utf8) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(utf8.data());
+    size_t n = utf8.size();
+
+    // Every code unit written consumes at least one input byte (a surrogate pair takes four)
+    std::wstring wide(n, L'\0');
+    wchar_t* out = &wide[0];
+    size_t i = 0, o = 0;
+
+    while (i < n) {
+        size_t run = widen_ascii(s + i, n - i, out + o);
+        i += run;
+        o += run;
+        if (i == n) {
+            break;
+        }
+
+        // Stay in the non-ASCII loop until the next ASCII byte (a whole Persian word, say)
+        while (i < n && s[i] >= 0x80) {
+            // Two-byte sequences (Arabic script, Cyrillic, ...) are the common case
+            if (s[i] >= 0xC2 && s[i] <= 0xDF && i + 1 < n && (s[i + 1] & 0xC0) == 0x80) {
+                out[o++] = static_cast<wchar_t>(((s[i] & 0x1F) << 6) | (s[i + 1] & 0x3F));
+                i += 2;
+                continue;
+            }
+
+            char32_t cp;
+            size_t consumed;
+            decode_sequence(s + i, n - i, cp, consumed);
+            i += consumed;
+            o += put_wide(out + o, cp);
+        }
+    }
+
+    wide.resize(o);
+    return wide;
+}
+
+std::string wide_to_utf8(const std::wstring& wide) {
+    const wchar_t* w = wide.data();
+    size_t n = wide.size();
+
+    // UTF-16: at most 3 bytes per unit (a pair is 4 bytes for 2 units); UTF-32: at most 4
+    std::string utf8(n * (WIDE_IS_UTF16 ? 3 : 4), '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&utf8[0]);
+    size_t i = 0, o = 0;
+
+    while (i < n) {
+        size_t run = narrow_ascii(w + i, n - i, out + o);
+        i += run;
+        o += run;
+        if (i == n) {
+            break;
+        }
+
+        while (i < n) {
+            char32_t cp = WIDE_IS_UTF16 ? static_cast<char32_t>(static_cast<uint16_t>(w[i]))
+                                        : static_cast<char32_t>(static_cast<uint32_t>(w[i]));
+            if (cp < 0x80) {
+                break;
+            }
+            i++;
+            if (WIDE_IS_UTF16 && cp >= 0xD800 && cp <= 0xDBFF && i < n) {
+                char32_t next = static_cast<uint16_t>(w[i]);
+                if (next >= 0xDC00 && next <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (next - 0xDC00);
+                    i++;
+                }
+            }
+            if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+                cp = REPLACEMENT;
+            }
+            o += put_utf8(out + o, cp);
+        }
+    }
+
+    utf8.resize(o);
+    return utf8;
+}
+
+bool utf8_is_valid(const std::string& utf8) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(utf8.data());
+    size_t n = utf8.size();
+    size_t i = 0;
+
+    while (i < n) {
+#ifdef UTF8_USE_SSE2
+        for (; i + 16 <= n; i += 16) {
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))) != 0) {
+                break;
+            }
+        }
+#endif
+        for (; i < n && s[i] < 0x80; i++) {}
+        if (i == n) {
+            break;
+        }
+
+        char32_t cp;
+        size_t consumed;
+        if (!decode_sequence(s + i, n - i, cp, consumed)) {
+            return false;
+        }
+        i += consumed;
+    }
+    return true;
+}
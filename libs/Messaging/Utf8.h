@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// UTF-8 <-> wchar_t transcoding without std::wstring_convert.
+// wchar_t is UTF-32 on Linux/macOS and UTF-16 on Windows; both are handled.
+//
+// Invalid input never throws and never drops the whole string: each maximal
+// invalid subsequence (as defined by Unicode, Table 3-7) becomes one U+FFFD.
+// Lone surrogates and code points above U+10FFFF in wide strings become U+FFFD too.
+//
+// Runs of ASCII are handled 16 bytes at a time with SSE2 on x86; everything
+// else (and other architectures) takes the scalar path.
+
+std::wstring utf8_to_wide(const std::string& utf8);
+std::string wide_to_utf8(const std::wstring& wide);
+
+// True if the bytes are well-formed UTF-8 (no overlongs, surrogates or values above U+10FFFF)
+bool utf8_is_valid(const std::string& utf8);
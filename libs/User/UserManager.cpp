@@ -34,6 +34,20 @@ bool UserManager::sendMessageToChatroom(const std::string& chatroomName, const s
     return database.sendMessage(currentUser, chatroomName, content);
 }
 
+bool UserManager::sendMessageToUser(const std::string& receiver, const std::string& content,
+                                    const std::string& clientKey, int& messageId) {
+    if (!isLoggedIn()) return false;
+    messageId = database.storeMessageOnce(clientKey, currentUser, receiver, content);
+    return messageId > 0;
+}
+
+bool UserManager::sendMessageToChatroom(const std::string& chatroomName, const std::string& content,
+                                        const std::string& clientKey, int& messageId) {
+    if (!isLoggedIn()) return false;
+    messageId = database.storeMessageOnce(clientKey, currentUser, chatroomName, content);
+    return messageId > 0;
+}
+
 
 bool UserManager::isLoggedIn() const {
     return !currentUser.empty();
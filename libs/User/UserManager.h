@@ -13,6 +13,11 @@ public:
     void logoutUser();
 bool sendMessageToUser(const std::string& receiver, const std::string& content);
 bool sendMessageToChatroom(const std::string& chatroomName, const std::string& content);
+    // Safe to retry: a repeated clientKey stores nothing and messageId is the first send's row id
+    bool sendMessageToUser(const std::string& receiver, const std::string& content,
+                           const std::string& clientKey, int& messageId);
+    bool sendMessageToChatroom(const std::string& chatroomName, const std::string& content,
+                               const std::string& clientKey, int& messageId);
     //bool deleteUser(const std::string& username); 
     bool isLoggedIn() const;
     std::string getCurrentUser() const;
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <functional>
+#include "../libs/Bot/BotManager.h"
+
+// دستورهای ربات با وابستگی‌های کند: اجرای ترتیبی در برابر استخر کارگر و مهلت
+
+static double measureMs(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static const std::chrono::milliseconds statsDelay(30);
+static const std::chrono::milliseconds searchDelay(60);
+static const std::chrono::milliseconds lastMessagesDelay(20);
+
+// Dependencies that behave like a loaded database: every call waits
+static BotManagerDeps slowDeps(std::chrono::milliseconds searchTime = searchDelay) {
+    BotManagerDeps deps;
+    deps.fetchStats = [] {
+        std::this_thread::sleep_for(statsDelay);
+        Stats s;
+        s.sentCount = 120;
+        s.receivedCount = 95;
+        s.topContactId = "ali";
+        return s;
+    };
+    deps.searchMessages = [searchTime](const std::string& query, size_t) {
+        std::this_thread::sleep_for(searchTime);
+        Message m;
+        m.fromUserId = "ali";
+        m.toUserId = "me";
+        m.text = "about " + query;
+        return std::vector<Message>{m};
+    };
+    deps.fetchLastMessages = [](size_t limit) {
+        std::this_thread::sleep_for(lastMessagesDelay);
+        return std::vector<Message>(limit);
+    };
+    return deps;
+}
+
+int main() {
+    const std::vector<int> dashboard = {static_cast<int>(MenuItem::Stats),
+                                        static_cast<int>(MenuItem::SearchMessages),
+                                        static_cast<int>(MenuItem::LastMessages)};
+    const std::unordered_map<std::string, std::string> args = {{"query", "meeting"}, {"limit", "3"}};
+    auto executor = std::make_shared<BotExecutor>(16);
+
+    // One user, three independent commands
+    BotManager bot(slowDeps(), {}, executor);
+    double sequentialMs = measureMs([&]() {
+        for (int choice : dashboard) {
+            bot.handleChoice(choice, args);
+        }
+    });
+    BotReply fanOut;
+    double parallelMs = measureMs([&]() { fanOut = bot.handleChoicesAsync(dashboard, args).get(); });
+
+    // Many users at once, all searching
+    const int users = 32;
+    std::vector<std::unique_ptr<BotManager>> bots;
+    for (int u = 0; u < users; u++) {
+        bots.push_back(std::make_unique<BotManager>(slowDeps(), BotManagerConfig{}, executor));
+    }
+    double oneByOneMs = users * static_cast<double>(searchDelay.count());
+    size_t completed = 0;
+    double concurrentMs = measureMs([&]() {
+        std::vector<std::future<BotReply>> replies;
+        for (auto& userBot : bots) {
+            replies.push_back(userBot->handleChoiceAsync(static_cast<int>(MenuItem::SearchMessages), args));
+        }
+        for (auto& reply : replies) {
+            completed += reply.get().complete;
+        }
+    });
+
+    // A search far slower than the deadline: the other sections still arrive on time
+    BotManagerConfig tight;
+    tight.commandDeadline = std::chrono::milliseconds(200);
+    BotManager slowSearchBot(slowDeps(std::chrono::milliseconds(1500)), tight, executor);
+    BotReply partial;
+    double partialMs = measureMs([&]() { partial = slowSearchBot.handleChoicesAsync(dashboard, args).get(); });
+
+    if (!fanOut.complete || completed != static_cast<size_t>(users) || partial.complete ||
+        partial.text.find("Stats:") == std::string::npos ||
+        partial.text.find("Not ready in time") == std::string::npos) {
+        std::cout << "❌ unexpected replies" << std::endl;
+        return 1;
+    }
+
+    std::cout << "🎯 BOT COMMANDS (stats " << statsDelay.count() << " ms, search " << searchDelay.count()
+              << " ms, last messages " << lastMessagesDelay.count() << " ms)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(34) << "3 commands, sequential" << std::right << std::setw(10)
+              << sequentialMs << " ms" << std::endl;
+    std::cout << std::left << std::setw(34) << "3 commands, fanned out" << std::right << std::setw(10)
+              << parallelMs << " ms" << std::endl;
+    std::cout << std::left << std::setw(34) << "32 users searching, one by one" << std::right << std::setw(10)
+              << oneByOneMs << " ms" << std::endl;
+    std::cout << std::left << std::setw(34) << "32 users searching, pool of 16" << std::right << std::setw(10)
+              << concurrentMs << " ms" << std::endl;
+    std::cout << std::left << std::setw(34) << "1.5 s search, 200 ms deadline" << std::right << std::setw(10)
+              << partialMs << " ms (partial reply)" << std::endl;
+
+    std::cout << "\nlatency (us)        p50        p99      count" << std::endl;
+    for (int choice : dashboard) {
+        const LatencyHistogram& h = executor->histogram(choice);
+        std::cout << std::left << std::setw(16) << (choice == dashboard[0] ? "stats" : choice == dashboard[1] ? "search" : "last messages")
+                  << std::right << std::setw(10) << h.percentileMicros(0.5) << std::setw(11) << h.percentileMicros(0.99)
+                  << std::setw(11) << h.count() << std::endl;
+    }
+    return 0;
+}
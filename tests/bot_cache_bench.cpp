@@ -0,0 +1,160 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include "../libs/Bot/BotManager.h"
+
+// کاربران پشت سر هم «خوانده‌نشده»، «آمار» و «آخرین پیام‌ها» را می‌پرسند؛ هر وابستگی کل پیام‌ها را پیمایش می‌کند
+
+static double measureMs(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static const int users = 50;
+static const int messagesInStore = 100000;
+static const int requestsPerUser = 400;
+static const int requestsPerMessage = 20;   // One new message every 20 bot requests
+
+struct Store {
+    std::vector<Message> messages;
+    size_t dependencyCalls = 0;
+};
+
+// Every dependency is a full scan, like the unindexed queries behind the bot
+static BotManagerDeps scanningDeps(std::shared_ptr<Store> store, const std::string& userId) {
+    BotManagerDeps deps;
+    deps.fetchUnreadCount = [store, userId] {
+        store->dependencyCalls++;
+        int unread = 0;
+        for (const auto& m : store->messages) unread += m.toUserId == userId && !m.isRead;
+        return unread;
+    };
+    deps.fetchStats = [store, userId] {
+        store->dependencyCalls++;
+        Stats s;
+        for (const auto& m : store->messages) {
+            s.sentCount += m.fromUserId == userId;
+            s.receivedCount += m.toUserId == userId;
+        }
+        return s;
+    };
+    deps.fetchLastMessages = [store, userId](size_t limit) {
+        store->dependencyCalls++;
+        std::vector<Message> result;
+        for (auto it = store->messages.rbegin(); it != store->messages.rend() && result.size() < limit; ++it) {
+            if (it->fromUserId == userId || it->toUserId == userId) result.push_back(*it);
+        }
+        return result;
+    };
+    return deps;
+}
+
+static std::string user(int u) { return "user" + std::to_string(u); }
+
+struct Run {
+    double ms;
+    size_t dependencyCalls;
+    size_t requests;
+    bool fresh;     // Every reply matched an uncached one
+};
+
+static Run run(bool cached, std::shared_ptr<BotResultCache> cache) {
+    auto store = std::make_shared<Store>();
+    for (int i = 0; i < messagesInStore; i++) {
+        Message m;
+        m.fromUserId = user(i % users);
+        m.toUserId = user((i * 7 + 3) % users);
+        m.text = "message " + std::to_string(i);
+        store->messages.push_back(m);
+    }
+
+    auto executor = std::make_shared<BotExecutor>(1);
+    std::vector<std::unique_ptr<BotManager>> bots;
+    std::vector<std::unique_ptr<BotManager>> references;    // Never cached: the expected answers
+    for (int u = 0; u < users; u++) {
+        BotManagerConfig cfg;
+        cfg.userId = cached ? user(u) : "";
+        bots.push_back(std::make_unique<BotManager>(scanningDeps(store, user(u)), cfg, executor, cache));
+        references.push_back(std::make_unique<BotManager>(scanningDeps(store, user(u)), BotManagerConfig{}, executor));
+    }
+
+    const int commands[] = {static_cast<int>(MenuItem::UnreadCount), static_cast<int>(MenuItem::Stats),
+                            static_cast<int>(MenuItem::LastMessages)};
+    Run result{0, 0, 0, true};
+    size_t requests = 0;
+    std::vector<std::pair<int, int>> checks;   // (user, command) to verify right after a new message
+    result.ms = measureMs([&]() {
+        for (int round = 0; round < requestsPerUser; round++) {
+            for (int u = 0; u < users; u++) {
+                int command = commands[(round + u) % 3];
+                bots[static_cast<size_t>(u)]->handleChoice(command);
+                if (++requests % requestsPerMessage == 0) {
+                    Message m;
+                    m.fromUserId = user(u);
+                    m.toUserId = user((u + round) % users);
+                    store->messages.push_back(m);
+                    bots[static_cast<size_t>(u)]->onMessageEvent(m.fromUserId, m.toUserId);
+                    checks.emplace_back(u, command);
+                }
+            }
+        }
+    });
+    result.dependencyCalls = store->dependencyCalls;
+    result.requests = requests;
+
+    // Spot checks outside the timed loop: cached replies after an event equal fresh ones
+    for (size_t i = 0; i < checks.size(); i += 97) {
+        auto [u, command] = checks[i];
+        result.fresh &= bots[static_cast<size_t>(u)]->handleChoice(command) ==
+                        references[static_cast<size_t>(u)]->handleChoice(command);
+    }
+    return result;
+}
+
+int main() {
+    auto cache = std::make_shared<BotResultCache>();
+    Run direct = run(false, nullptr);
+    Run cached = run(true, cache);
+    BotResultCache::Stats stats = cache->stats();
+
+    // A cap far below the working set: LRU keeps memory bounded
+    auto smallCache = std::make_shared<BotResultCache>(16 << 10);
+    run(true, smallCache);
+    BotResultCache::Stats small = smallCache->stats();
+
+    // Message events for users with nothing cached must not leave a record behind each
+    for (int u = 0; u < 100000; ++u) cache->invalidateMessages("guest" + std::to_string(u));
+    size_t records = cache->stats().users;
+
+    if (!direct.fresh || !cached.fresh || small.bytes > (16 << 10) || small.evictions == 0 ||
+        records > users * 2 + BotResultCache::kSweepSlack) {
+        std::cout << "❌ stale replies, cache over its cap or unbounded user records" << std::endl;
+        return 1;
+    }
+
+    std::cout << "🎯 BOT QUERIES (" << users << " users, " << messagesInStore << " messages, "
+              << direct.requests << " requests, a new message every " << requestsPerMessage << ")" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(14) << "" << std::right << std::setw(14) << "us/request"
+              << std::setw(12) << "db scans" << std::setw(12) << "hit rate" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(14) << "no cache" << std::right << std::setw(14)
+              << direct.ms * 1000 / static_cast<double>(direct.requests) << std::setw(12) << direct.dependencyCalls
+              << std::setw(12) << "-" << std::endl;
+    std::cout << std::left << std::setw(14) << "ttl cache" << std::right << std::setw(14)
+              << cached.ms * 1000 / static_cast<double>(cached.requests) << std::setw(12) << cached.dependencyCalls
+              << std::setw(11) << 100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses)
+              << "%" << std::endl;
+    std::cout << "\ninvalidated: " << stats.invalidated << ", expired: " << stats.expired
+              << ", entries: " << stats.entries << " (" << stats.bytes / 1024 << " KB)" << std::endl;
+    std::cout << "16 KB cap: " << small.entries << " entries, " << small.bytes / 1024 << " KB, "
+              << small.evictions << " evictions" << std::endl;
+    std::cout << "user records after 100000 guest events: " << records << std::endl;
+    return 0;
+}
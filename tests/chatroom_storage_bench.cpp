@@ -0,0 +1,129 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include "../libs/ChatRoom/ChatRoomManager.h"
+#include "../libs/ChatRoom/CompactMessageStore.h"
+
+// مقایسه‌ی چیدمان فعلی (vector<ChatMessage>) با CompactMessageStore
+
+static double measureMs(const std::function<void()>& fn, int repeat = 5) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+}
+
+static size_t estimateVectorBytes(const std::vector<ChatMessage>& messages) {
+    // Node size of std::set<int> is implementation defined; 40 bytes is typical for 64-bit libstdc++
+    const size_t setNodeBytes = 40;
+    const size_t ssoCapacity = std::string().capacity();
+
+    // MessageContent is a make_shared<const std::string>: control block + string object
+    const size_t sharedContentBytes = 16 + sizeof(std::string);
+
+    size_t bytes = messages.capacity() * sizeof(ChatMessage);
+    for (const auto& msg : messages) {
+        bytes += sharedContentBytes;
+        if (msg.content.str().capacity() > ssoCapacity) bytes += msg.content.str().capacity() + 1;
+        if (msg.attachmentPath.capacity() > ssoCapacity) bytes += msg.attachmentPath.capacity() + 1;
+        bytes += msg.readBy.size() * setNodeBytes;
+    }
+    return bytes;
+}
+
+static void printRow(const std::string& name, double vectorMs, double compactMs) {
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3) << vectorMs
+              << std::setw(12) << compactMs
+              << std::setw(10) << std::setprecision(1) << (compactMs > 0 ? vectorMs / compactMs : 0) << "x"
+              << std::endl;
+}
+
+static void runBenchmark(size_t messageCount) {
+    std::cout << "\n📦 " << messageCount << " messages" << std::endl;
+    std::cout << "==========================================" << std::endl;
+
+    std::vector<ChatMessage> messages;
+    CompactMessageStore store;
+    messages.reserve(messageCount);
+
+    std::time_t base = 1700000000;
+    for (size_t i = 0; i < messageCount; i++) {
+        int id = static_cast<int>(i + 1);
+        int sender = static_cast<int>(i % 50);
+        int replyTo = (i % 10 == 0 && i > 0) ? id - 1 : -1;
+        ChatMessage msg(id, sender, "Message body number " + std::to_string(i) + " with some typical chat text",
+                        i % 100 == 0 ? "files/attachment.png" : "", replyTo);
+        msg.timestamp = base + static_cast<std::time_t>(i);
+        if (i % 3 == 0) msg.readBy.insert(7);
+        messages.push_back(msg);
+        store.append(msg);
+    }
+
+    std::cout << std::left << std::setw(22) << "operation"
+              << std::right << std::setw(12) << "vector ms" << std::setw(12) << "compact ms"
+              << std::setw(11) << "speedup" << std::endl;
+
+    volatile long sink = 0;
+
+    printRow("unread count",
+             measureMs([&]() {
+                 int count = 0;
+                 for (const auto& msg : messages) if (!msg.isReadBy(7)) count++;
+                 sink = sink + count;
+             }),
+             measureMs([&]() { sink = sink + store.countUnread(7); }));
+
+    printRow("reply filter",
+             measureMs([&]() {
+                 size_t count = 0;
+                 for (const auto& msg : messages) if (msg.isReply()) count++;
+                 sink = sink + count;
+             }),
+             measureMs([&]() { sink = sink + store.replies().size(); }));
+
+    std::time_t from = base + messageCount / 4;
+    std::time_t to = base + messageCount / 2;
+    printRow("time range",
+             measureMs([&]() {
+                 size_t count = 0;
+                 for (const auto& msg : messages) if (msg.timestamp >= from && msg.timestamp <= to) count++;
+                 sink = sink + count;
+             }),
+             measureMs([&]() { sink = sink + store.inTimeRange(from, to).size(); }));
+
+    const int lookups = 1000;
+    printRow("lookup x1000",
+             measureMs([&]() {
+                 for (int i = 0; i < lookups; i++) {
+                     int id = static_cast<int>((i * 7919) % messageCount) + 1;
+                     for (const auto& msg : messages) {
+                         if (msg.id == id) { sink = sink + msg.senderId; break; }
+                     }
+                 }
+             }, 1),
+             measureMs([&]() {
+                 for (int i = 0; i < lookups; i++) {
+                     int id = static_cast<int>((i * 7919) % messageCount) + 1;
+                     sink = sink + store.senderAt(store.findPosition(id));
+                 }
+             }, 1));
+
+    double vectorBytes = static_cast<double>(estimateVectorBytes(messages)) / messageCount;
+    double compactBytes = static_cast<double>(store.memoryUsage()) / messageCount;
+    std::cout << "bytes/message: vector ≈ " << std::setprecision(1) << vectorBytes
+              << ", compact ≈ " << compactBytes << std::endl;
+}
+
+int main() {
+    std::cout << "🎯 CHATROOM MESSAGE STORAGE BENCHMARK" << std::endl;
+    std::cout << "==========================================" << std::endl;
+
+    for (size_t count : {10000u, 100000u, 1000000u}) {
+        runBenchmark(count);
+    }
+    return 0;
+}
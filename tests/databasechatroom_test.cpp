@@ -87,8 +87,14 @@ public:
                 // بررسی پیام فوروارد شده
                 auto targetMessages = targetRoom->getMessages();
                 bool forwardSuccess = !targetMessages.empty() && 
-                                    targetMessages.back().content.find("Forwarded") != std::string::npos;
+                                    targetMessages.back().getForwardHeader().find("Forwarded") != std::string::npos &&
+                                    targetMessages.back().content == "Message to forward";
                 printTestResult("Forwarded message received", forwardSuccess);
+
+                // محتوای پیام فوروارد شده کپی نمی‌شود
+                bool sharedBody = !targetMessages.empty() &&
+                                  targetMessages.back().content.sharesBufferWith(messages.back().content);
+                printTestResult("Forward shares message body", sharedBody);
             }
         }
     }
@@ -189,6 +195,27 @@ public:
             results.clear();
             auto searchResult3 = room->searchMessages("nonexistent", results);
             printTestResult("Search for non-existent word", searchResult3.success && results.empty());
+
+            // جستجوی پیشوندی با صفحه‌بندی
+            std::vector<int> ids;
+            auto searchResult4 = room->searchMessageIds("import", ids, 0, 1);
+            printTestResult("Prefix search with paging", searchResult4.success && ids.size() == 1);
+
+            ids.clear();
+            room->searchMessageIds("import", ids, 1, 10);
+            printTestResult("Prefix search second page", ids.size() == 1);
+
+            // چند پیشوند: فقط پیام‌هایی که همه را دارند، به ترتیب اتاق
+            results.clear();
+            room->searchMessages("an no", results);
+            printTestResult("Prefixes intersected", results.size() == 1 &&
+                            results[0].content == "Another important notification");
+            ids.clear();
+            room->searchMessageIds("i", ids, 0, 1);
+            std::vector<int> rest;
+            room->searchMessageIds("i", rest, 1, 10);
+            printTestResult("Short prefix pages without overlap",
+                            ids.size() == 1 && rest.size() == 1 && ids[0] < rest[0]);
         }
     }
 
@@ -220,6 +247,23 @@ public:
                 messages = room->getMessages();
                 bool isReply = messages.size() >= 2 && messages.back().isReply();
                 printTestResult("Message is marked as reply", isReply);
+
+                // بررسی رشته‌ی پاسخ‌ها
+                room->sendMessage(1, "Second reply", "", originalMessageId);
+                auto thread = room->getReplies(originalMessageId);
+                bool threadOk = thread.size() == 2 && thread[1].content == "Second reply";
+                printTestResult("Thread replies in order", threadOk);
+
+                auto page = room->getReplies(originalMessageId, 1, 1);
+                printTestResult("Thread replies paging", page.size() == 1 && page[0].content == "Second reply");
+
+                if (threadOk) {
+                    room->deleteMessage(thread[0].id, 1);
+                    printTestResult("Deleted reply leaves thread", room->getReplyCount(originalMessageId) == 1);
+                    auto remaining = room->getReplies(originalMessageId);
+                    printTestResult("Later messages found after delete",
+                                   remaining.size() == 1 && remaining[0].content == "Second reply");
+                }
             }
         }
     }
@@ -257,6 +301,185 @@ public:
         }
     }
 
+    void testChannelMode() {
+        std::cout << "\n8. 📢 CHANNEL MODE TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        ChatRoom* channel = nullptr;
+        auto createResult = chatManager.createChannel("News Channel", "Broadcast only", "", 1, channel);
+        printTestResult("Create channel", createResult.success && channel && channel->getIsChannel());
+
+        if (channel) {
+            // افزودن مشترکین
+            for (int userId = 100; userId < 110; userId++) {
+                channel->addMember(userId);
+            }
+            printTestResult("Subscribers stored in bitmap", channel->getSubscriberCount() == 10);
+            printTestResult("Subscriber is member", channel->isMember(105));
+            printTestResult("Members include owner and subscribers", channel->getMembers().size() == 11);
+
+            // فقط ادمین‌ها پست می‌گذارند
+            auto subscriberPost = channel->sendMessage(105, "Not allowed");
+            printTestResult("Subscriber cannot post", !subscriberPost.success);
+
+            channel->sendMessage(1, "First post");
+            channel->sendMessage(1, "Second post");
+            printTestResult("Unread via watermark", channel->getUnreadCount(105) == 2);
+
+            auto messages = channel->getMessages();
+            if (!messages.empty()) {
+                channel->markMessageAsRead(messages.back().id, 105);
+                printTestResult("Read watermark advances", channel->getUnreadCount(105) == 0 &&
+                                                           channel->getUnreadCount(106) == 2);
+            }
+
+            auto removeResult = channel->removeMember(1, 105);
+            printTestResult("Remove subscriber", removeResult.success && !channel->isMember(105));
+        }
+    }
+
+    void testBulkMembership() {
+        std::cout << "\n9. 👥 BULK MEMBERSHIP TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        ChatRoom* room = nullptr;
+        chatManager.createRoom("Bulk Room", "For bulk import", "", false, 1, room);
+
+        if (room) {
+            std::vector<int> userIds;
+            for (int userId = 1000; userId < 3000; userId++) {
+                userIds.push_back(userId);
+            }
+            userIds.push_back(1);      // مالک از قبل عضو است
+            userIds.push_back(1000);   // تکراری در همین دسته
+
+            std::vector<OperationResult> results;
+            auto bulkResult = chatManager.addMembersToRoom(room->getId(), userIds, results);
+            printTestResult("Bulk add members", bulkResult.success && results.size() == userIds.size());
+            printTestResult("All new members added", room->getActiveMembersCount() == 2001,
+                           std::to_string(room->getActiveMembersCount()) + " members");
+            printTestResult("Existing and duplicate ids rejected",
+                            results[results.size() - 2].error == ChatRoomError::USER_ALREADY_MEMBER &&
+                            results.back().error == ChatRoomError::USER_ALREADY_MEMBER);
+        }
+    }
+
+    void testRateLimiting() {
+        std::cout << "\n10. ⏳ RATE LIMITING TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        ChatRoom* room = nullptr;
+        chatManager.createRoom("Limited Room", "For admission control", "", false, 1, room);
+
+        if (room) {
+            RateLimiterConfig config;
+            config.perUser = {0.01, 2};   // دو پیام پشت سر هم، سپس تقریباً هیچ
+            chatManager.setRateLimits(config);
+            size_t storedBefore = room->getMessages().size();
+
+            auto first = room->sendMessage(1, "first");
+            auto second = room->sendMessage(1, "second");
+            auto third = room->sendMessage(1, "third");
+            printTestResult("Burst admitted", first.success && second.success);
+            printTestResult("Over-limit send rejected", !third.success && third.error == ChatRoomError::RATE_LIMITED,
+                            third.message);
+            printTestResult("Retry-after hint given", third.retryAfterMs > 0,
+                            std::to_string(third.retryAfterMs) + " ms");
+            printTestResult("Rejected message not stored", room->getMessages().size() == storedBefore + 2);
+            printTestResult("Shed request counted", chatManager.getRateLimiterStats().shedByUser == 1);
+
+            chatManager.setRateLimits(RateLimiterConfig());
+            printTestResult("Unlimited again", room->sendMessage(1, "fourth").success);
+        }
+    }
+
+    void testIdempotentSend() {
+        std::cout << "\n11. 🔁 IDEMPOTENT SEND TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        ChatRoom* room = nullptr;
+        chatManager.createRoom("Retry Room", "For client keys", "", false, 1, room);
+
+        if (room) {
+            size_t storedBefore = room->getMessages().size();
+            auto first = room->sendMessage(1, "sent once", "", -1, "key-1");
+            auto retry = room->sendMessage(1, "sent once", "", -1, "key-1");
+            printTestResult("Keyed send stored", first.success && first.messageId > 0);
+            printTestResult("Retry returns original id", retry.success && retry.messageId == first.messageId,
+                            std::to_string(retry.messageId));
+            printTestResult("Retry not stored again", room->getMessages().size() == storedBefore + 1);
+
+            // کلید فقط برای همان فرستنده یکتاست
+            room->addMember(2);
+            auto other = room->sendMessage(2, "same key, other sender", "", -1, "key-1");
+            printTestResult("Same key from another sender stored",
+                            other.success && other.messageId != first.messageId &&
+                            room->getMessages().size() == storedBefore + 2);
+
+            auto rowId = database->storeMessageOnce("key-1", "1", std::to_string(room->getId()), "sent once");
+            auto rowIdAgain = database->storeMessageOnce("key-1", "1", std::to_string(room->getId()), "sent once");
+            printTestResult("Database keeps one row per key", rowId > 0 && rowId == rowIdAgain);
+
+            // ردیفی که قبل از این اجرا ذخیره شده، تنها یک بار در حافظه می‌آید
+            database->storeMessageOnce("key-2", "1", std::to_string(room->getId()), "stored earlier");
+            auto late = room->sendMessage(1, "stored earlier", "", -1, "key-2");
+            auto lateRetry = room->sendMessage(1, "stored earlier", "", -1, "key-2");
+            printTestResult("Row from an earlier run kept once",
+                            late.success && lateRetry.messageId == late.messageId &&
+                            room->getMessages().size() == storedBefore + 3 &&
+                            room->getMessages().back().content == "stored earlier");
+
+            // پس از راه‌اندازی دوباره پیام از دیتابیس با شناسه‌ی ردیفش بارگذاری شده است
+            room->sendMessage(1, "hello after restart", "", -1, "key-3");
+            ChatRoom restarted(room->getId(), "Retry Room", "For client keys", "", false, 1, database);
+            auto again = restarted.sendMessage(1, "hello after restart", "", -1, "key-3");
+            int copies = 0;
+            int loadedId = -1;
+            for (const auto& msg : restarted.getMessages()) {
+                if (msg.content == "hello after restart") {
+                    copies++;
+                    loadedId = msg.id;
+                }
+            }
+            printTestResult("Retry after reload returns the loaded message",
+                            again.success && copies == 1 && again.messageId == loadedId,
+                            std::to_string(copies) + " copies");
+        }
+    }
+
+    void testReminderPersistence() {
+        std::cout << "\n12. ⏰ REMINDER PERSISTENCE TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        StoredReminder later{"rem-later", "alice", "Call Bob", 4102444800000LL};
+        StoredReminder sooner{"rem-sooner", "alice", "Standup", 4102444700000LL};
+        printTestResult("Reminders saved", database->saveReminder(later) && database->saveReminder(sooner));
+
+        later.title = "Call Bob back";
+        printTestResult("Same id replaces", database->saveReminder(later));
+
+        // پس از باز کردن دوباره، همان چیزی که زمان‌بند بازیابی می‌کند
+        std::vector<StoredReminder> loaded;
+        {
+            Database reopened("full_test.db");
+            loaded = reopened.loadReminders();
+        }
+        int ours = 0;
+        bool ordered = true;
+        long long lastDue = 0;
+        for (const auto& r : loaded) {
+            ordered &= r.dueAtMs >= lastDue;
+            lastDue = r.dueAtMs;
+            if (r.id == "rem-later") ours += r.title == "Call Bob back" && r.username == "alice";
+            if (r.id == "rem-sooner") ours += r.dueAtMs == 4102444700000LL;
+        }
+        printTestResult("Reminders recovered after reopen", ours == 2 && ordered, std::to_string(loaded.size()));
+
+        printTestResult("Delivered reminder deleted", database->deleteReminder("rem-sooner"));
+        printTestResult("Second delete finds nothing", !database->deleteReminder("rem-sooner"));
+        database->deleteReminder("rem-later");
+    }
+
     void runAllTests() {
         std::cout << "🎯 COMPREHENSIVE CHATROOM FEATURE TESTS" << std::endl;
         std::cout << "==========================================" << std::endl;
@@ -269,6 +492,11 @@ public:
             testMessageSearch();
             testMessageReplies();
             testAdminFunctions();
+            testChannelMode();
+            testBulkMembership();
+            testRateLimiting();
+            testIdempotentSend();
+            testReminderPersistence();
 
             std::cout << "\n==========================================" << std::endl;
             std::cout << "📊 FINAL RESULTS: " << passedCount << "/" << testCount << " tests passed" << std::endl;
@@ -99,6 +99,53 @@ int main() {
         std::vector<Chat> userChats = db.getUserChats("john_doe");
         std::cout << "Number of chat conversations: " << userChats.size() << std::endl;
 
+        // Test 9b: Change Events
+        std::cout << "\n--- Test 9b: Change Events ---" << std::endl;
+        std::vector<ChangeEvent> events;
+        int subscription = db.subscribe([&events](const ChangeEvent& e) { events.push_back(e); });
+        userManager.sendMessageToUser("jane_smith", "Event check");
+        bool testEvents1 = events.size() == 1 && events[0].type == ChangeType::MessageInserted &&
+                           events[0].receiver == "jane_smith" && events[0].messageId > 0;
+        printTestResult("Insert publishes MessageInserted", testEvents1);
+        allTestsPassed &= testEvents1;
+
+        if (testEvents1) {
+            db.markMessageAsRead(events[0].messageId);
+            bool testEvents2 = events.size() == 2 && events[1].type == ChangeType::MessageRead &&
+                               events[1].sender == "john_doe";
+            printTestResult("Read publishes MessageRead", testEvents2);
+            allTestsPassed &= testEvents2;
+        }
+
+        db.unsubscribe(subscription);
+        size_t seen = events.size();
+        userManager.sendMessageToUser("jane_smith", "After unsubscribe");
+        bool testEvents3 = events.size() == seen;
+        printTestResult("Unsubscribed listener is not called", testEvents3);
+        allTestsPassed &= testEvents3;
+
+        // Test 9c: Idempotent Send
+        std::cout << "\n--- Test 9c: Idempotent Send ---" << std::endl;
+        events.clear();
+        subscription = db.subscribe([&events](const ChangeEvent& e) { events.push_back(e); });
+        int firstId = -1;
+        int retryId = -1;
+        bool testKeyed1 = userManager.sendMessageToUser("jane_smith", "Sent once", "client-key-1", firstId) &&
+                          userManager.sendMessageToUser("jane_smith", "Sent once", "client-key-1", retryId);
+        printTestResult("Retry with the same key succeeds", testKeyed1);
+        allTestsPassed &= testKeyed1;
+
+        bool testKeyed2 = firstId > 0 && retryId == firstId && events.size() == 1;
+        printTestResult("Retry returns the original id and stores nothing", testKeyed2);
+        allTestsPassed &= testKeyed2;
+
+        int otherId = -1;
+        bool testKeyed3 = userManager.sendMessageToUser("jane_smith", "Next one", "client-key-2", otherId) &&
+                          otherId != firstId && events.size() == 2;
+        printTestResult("A new key stores a new message", testKeyed3);
+        allTestsPassed &= testKeyed3;
+        db.unsubscribe(subscription);
+
         // Test 11: Logout
         std::cout << "\n--- Test 10: User Logout ---" << std::endl;
         userManager.logoutUser();
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include "../libs/DataBase/Database.h"
+#include "../libs/User/UserManager.h"
+
+// طوفان تلاش مجدد: هر پیام پس از تایم‌اوت چند بار دوباره فرستاده می‌شود
+
+static double measureMs(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static const int messages = 2000;
+static const int retriesPerMessage = 4;
+
+struct Result {
+    int rows;
+    double firstSendMs;
+    double retriesMs;
+    int retries;
+};
+
+// Sends every message, then retries all of them. keyed = with a client message key.
+static Result run(Database& db, bool keyed) {
+    UserManager users(db);
+    users.registerUser("sender", "password");
+    users.loginUser("sender", "password");
+
+    Result result{};
+    int messageId;
+    result.firstSendMs = measureMs([&]() {
+        for (int m = 0; m < messages; m++) {
+            std::string content = "message " + std::to_string(m);
+            if (keyed) {
+                users.sendMessageToUser("reader", content, "key-" + std::to_string(m), messageId);
+            } else {
+                users.sendMessageToUser("reader", content);
+            }
+        }
+    });
+    result.retriesMs = measureMs([&]() {
+        for (int r = 0; r < retriesPerMessage; r++) {
+            for (int m = 0; m < messages; m++) {
+                std::string content = "message " + std::to_string(m);
+                if (keyed) {
+                    users.sendMessageToUser("reader", content, "key-" + std::to_string(m), messageId);
+                } else {
+                    users.sendMessageToUser("reader", content);
+                }
+            }
+        }
+    });
+    result.retries = messages * retriesPerMessage;
+    result.rows = db.getTotalMessagesSent("sender");
+    return result;
+}
+
+int main() {
+    const std::string plainPath = "retries_plain.db";
+    const std::string keyedPath = "retries_keyed.db";
+    std::remove(plainPath.c_str());
+    std::remove(keyedPath.c_str());
+
+    Result plain, keyed, keyedAfterRestart;
+    {
+        Database db(plainPath);
+        plain = run(db, false);
+    }
+    {
+        Database db(keyedPath);
+        keyed = run(db, true);
+    }
+    {
+        // A new process: the window is empty and every retry falls through to the unique index
+        Database db(keyedPath);
+        UserManager users(db);
+        users.loginUser("sender", "password");
+        int messageId;
+        keyedAfterRestart.retriesMs = measureMs([&]() {
+            for (int m = 0; m < messages; m++) {
+                users.sendMessageToUser("reader", "message " + std::to_string(m), "key-" + std::to_string(m), messageId);
+            }
+        });
+        keyedAfterRestart.retries = messages;
+        keyedAfterRestart.rows = db.getTotalMessagesSent("sender");
+    }
+    std::remove(plainPath.c_str());
+    std::remove(keyedPath.c_str());
+
+    if (keyed.rows != messages || keyedAfterRestart.rows != messages) {
+        std::cout << "❌ retries stored duplicates" << std::endl;
+        return 1;
+    }
+
+    std::cout << "🎯 RETRY STORM (" << messages << " messages, " << retriesPerMessage << " retries each)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(24) << "" << std::right << std::setw(10) << "rows"
+              << std::setw(16) << "first send us" << std::setw(12) << "retry us" << std::endl;
+    auto row = [&](const char* name, const Result& r, bool hasFirst) {
+        std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << r.rows
+                  << std::fixed << std::setprecision(2) << std::setw(16);
+        if (hasFirst) {
+            std::cout << r.firstSendMs * 1000 / messages;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::setw(12) << r.retriesMs * 1000 / r.retries << std::endl;
+    };
+    row("no key", plain, true);
+    row("client key", keyed, true);
+    row("client key, restarted", keyedAfterRestart, false);
+    return 0;
+}
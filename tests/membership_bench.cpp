@@ -0,0 +1,98 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <string>
+#include <random>
+#include <chrono>
+#include <functional>
+#include "../libs/ChatRoom/MemberSet.h"
+
+// مقایسه‌ی std::set<int> با MemberSet برای isMember/isAdmin
+
+static double measureNsPerOp(const std::function<void()>& fn, size_t ops) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+static const char* representationName(MemberSet::Representation r) {
+    switch (r) {
+        case MemberSet::Representation::Flat: return "flat";
+        case MemberSet::Representation::Bitmap: return "bitmap";
+        case MemberSet::Representation::Hash: return "hash";
+    }
+    return "?";
+}
+
+static void runBenchmark(const std::string& label, const std::vector<int>& ids) {
+    std::mt19937 rng(42);
+    std::vector<int> probes;
+    const size_t probeCount = 1000000;
+    probes.reserve(probeCount);
+    for (size_t i = 0; i < probeCount; i++) {
+        // Half hits, half misses
+        probes.push_back(i % 2 ? ids[rng() % ids.size()] : static_cast<int>(rng()));
+    }
+
+    std::set<int> tree;
+    MemberSet compact;
+    volatile long sink = 0;
+
+    double treeInsert = measureNsPerOp([&]() { for (int id : ids) tree.insert(id); }, ids.size());
+    double compactInsert = measureNsPerOp([&]() { for (int id : ids) compact.insert(id); }, ids.size());
+
+    double treeLookup = measureNsPerOp([&]() {
+        long hits = 0;
+        for (int id : probes) hits += tree.count(id);
+        sink = sink + hits;
+    }, probes.size());
+    double compactLookup = measureNsPerOp([&]() {
+        long hits = 0;
+        for (int id : probes) hits += compact.count(id);
+        sink = sink + hits;
+    }, probes.size());
+
+    double treeIterate = measureNsPerOp([&]() {
+        long sum = 0;
+        for (int id : tree) sum += id;
+        sink = sink + sum;
+    }, ids.size());
+    double compactIterate = measureNsPerOp([&]() {
+        long sum = 0;
+        compact.forEach([&sum](int id) { sum += id; });
+        sink = sink + sum;
+    }, ids.size());
+
+    std::cout << std::left << std::setw(16) << label
+              << std::setw(8) << representationName(compact.representation())
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << treeInsert << std::setw(10) << compactInsert
+              << std::setw(10) << treeLookup << std::setw(10) << compactLookup
+              << std::setw(10) << treeIterate << std::setw(10) << compactIterate
+              << std::endl;
+}
+
+int main() {
+    std::cout << "🎯 MEMBERSHIP MICROBENCHMARK (ns/op, set vs MemberSet)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(16) << "members" << std::setw(8) << "repr"
+              << std::right << std::setw(10) << "ins set" << std::setw(10) << "ins new"
+              << std::setw(10) << "look set" << std::setw(10) << "look new"
+              << std::setw(10) << "iter set" << std::setw(10) << "iter new" << std::endl;
+
+    std::mt19937 rng(7);
+    for (size_t count : {10u, 1000u, 1000000u}) {
+        // Dense: user IDs handed out sequentially, as registration does
+        std::vector<int> dense;
+        for (size_t i = 0; i < count; i++) dense.push_back(static_cast<int>(100000 + i));
+        runBenchmark(std::to_string(count) + " dense", dense);
+
+        // Sparse: members scattered over the whole ID space
+        std::vector<int> sparse;
+        for (size_t i = 0; i < count; i++) sparse.push_back(static_cast<int>(rng() & 0x7fffffff));
+        runBenchmark(std::to_string(count) + " sparse", sparse);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <unordered_set>
+#include <functional>
+#include "../libs/Messaging/MessageId.h"
+
+// مقایسه‌ی generate_id قدیمی (random_device + mt19937 برای هر شناسه) با MessageId
+
+static std::wstring oldGenerateId() {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(0, 15);
+    const wchar_t* hex_chars = L"0123456789abcdef";
+    std::wstring id;
+    for (int i = 0; i < 32; ++i) {
+        id += hex_chars[dis(gen)];
+    }
+    return id;
+}
+
+static double measureNsPerOp(const std::function<void()>& fn, size_t ops) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+static bool check(const std::string& name, bool ok) {
+    std::cout << (ok ? "✅ " : "❌ ") << name << std::endl;
+    return ok;
+}
+
+int main() {
+    std::cout << "🎯 MESSAGE ID GENERATION" << std::endl;
+    std::cout << "==========================================" << std::endl;
+
+    // Uniqueness and ordering across threads
+    const size_t threads = 4, perThread = 200000;
+    std::vector<std::vector<MessageId>> generated(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&generated, t]() {
+            generated[t].reserve(perThread);
+            for (size_t i = 0; i < perThread; i++) generated[t].push_back(MessageId::next());
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::unordered_set<MessageId> unique;
+    bool increasing = true, textOrdered = true, roundTrip = true;
+    for (const auto& ids : generated) {
+        for (size_t i = 0; i < ids.size(); i++) {
+            unique.insert(ids[i]);
+            if (i > 0) {
+                increasing &= ids[i - 1] < ids[i];
+                textOrdered &= ids[i - 1].to_wstring() < ids[i].to_wstring();
+            }
+            MessageId parsed;
+            roundTrip &= MessageId::parse(ids[i].to_wstring(), parsed) && parsed == ids[i];
+        }
+    }
+    bool ok = true;
+    ok &= check("Unique across threads", unique.size() == threads * perThread);
+    ok &= check("Strictly increasing per thread", increasing);
+    ok &= check("Text order equals id order", textOrdered);
+    ok &= check("Text form parses back", roundTrip);
+    MessageId ignored;
+    ok &= check("Malformed text rejected", !MessageId::parse(L"not-an-id", ignored) &&
+                                           !MessageId::parse(std::wstring(26, L'Z'), ignored));
+    if (!ok) {
+        return 1;
+    }
+
+    const size_t oldOps = 20000, newOps = 2000000;
+    volatile size_t sink = 0;
+    double oldNs = measureNsPerOp([&]() { for (size_t i = 0; i < oldOps; i++) sink = sink + oldGenerateId().size(); }, oldOps);
+    double binaryNs = measureNsPerOp([&]() { for (size_t i = 0; i < newOps; i++) sink = sink + MessageId::next().low; }, newOps);
+    double textNs = measureNsPerOp([&]() {
+        for (size_t i = 0; i < newOps; i++) sink = sink + MessageId::next().to_wstring().size();
+    }, newOps);
+
+    std::cout << "\nns per id" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  old (random_device, 32 hex): " << oldNs << std::endl
+              << "  MessageId binary:            " << binaryNs << std::endl
+              << "  MessageId + 26-char text:    " << textNs << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include "../libs/Messaging/MessageStore.h"
+
+// حافظه‌ی هر پیام: vector<ChatMessage> در برابر رکورد فشرده‌ی MessageStore با جدول‌های جانبی
+
+static size_t liveHeapBytes = 0;
+
+// A header in front of each block remembers its size for operator delete
+static const uintptr_t headerBytes = sizeof(std::max_align_t);
+
+void* operator new(size_t size) {
+    uintptr_t block = reinterpret_cast<uintptr_t>(std::malloc(size + headerBytes));
+    if (!block) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(block) = size;
+    liveHeapBytes += size;
+    return reinterpret_cast<void*>(block + headerBytes);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    uintptr_t block = reinterpret_cast<uintptr_t>(ptr) - headerBytes;
+    liveHeapBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(reinterpret_cast<void*>(block));
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+static std::vector<ChatMessage> makeMessages(size_t count) {
+    std::mt19937 rng(3);
+    const std::vector<std::wstring> texts = {
+        L"ok", L"see you tomorrow", L"سلام، خوبی؟", L"can you send the report before the meeting?",
+        L"👍", L"جلسه ساعت ۱۰ برگزار می‌شود", L"thanks!", L"I pushed the fix, please review when you can"
+    };
+    std::vector<ChatMessage> messages;
+    messages.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ChatMessage msg;
+        msg.id = MessageId::next().to_wstring();
+        msg.sender = L"user" + std::to_wstring(rng() % 2000);
+        msg.receiver = L"user" + std::to_wstring(rng() % 2000);
+        msg.content = texts[rng() % texts.size()];
+        msg.timestamp = static_cast<time_t>(1700000000 + i);
+        msg.edit_expiry_time = msg.timestamp + 15 * 60;
+        msg.is_delivered = msg.is_seen = msg.is_read = rng() % 3 != 0;
+
+        // Roughly what a chat looks like: replies, forwards and files are the exception
+        unsigned kind = rng() % 100;
+        if (kind < 6) {
+            msg.replied_to_id = MessageId::next().to_wstring();
+            msg.replied_to_sender = msg.receiver;
+            msg.replied_to_content = texts[rng() % texts.size()];
+        } else if (kind < 9) {
+            msg.is_forwarded = true;
+            msg.original_sender = L"user" + std::to_wstring(rng() % 2000);
+        } else if (kind < 11) {
+            msg.has_attachment = true;
+            msg.file_name = L"photo_" + std::to_wstring(i) + L".jpg";
+            msg.file_path = L"/home/user/Downloads/" + msg.file_name;
+        }
+        messages.push_back(std::move(msg));
+    }
+    return messages;
+}
+
+int main() {
+    std::cout << "🎯 MESSAGE MEMORY (bytes per message)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(12) << "messages" << std::right
+              << std::setw(20) << "vector<ChatMessage>" << std::setw(16) << "MessageStore"
+              << std::setw(18) << "memory_usage()" << std::endl;
+
+    for (size_t count : {10000u, 100000u, 1000000u}) {
+        std::vector<ChatMessage> source = makeMessages(count);
+
+        size_t before = liveHeapBytes;
+        std::vector<ChatMessage> copy(source.begin(), source.end());
+        double vectorBytes = static_cast<double>(liveHeapBytes - before) / count;
+
+        before = liveHeapBytes;
+        MessageStore* store = new MessageStore();
+        for (const auto& msg : source) store->add(msg);
+        double storeBytes = static_cast<double>(liveHeapBytes - before) / count;
+        double estimate = static_cast<double>(store->memory_usage()) / count;
+
+        // Spot-check that the compact form round-trips
+        for (size_t i = 0; i < count; i += count / 100) {
+            ChatMessage back;
+            if (!store->get(source[i].id, back) || back.content != source[i].content ||
+                back.replied_to_content != source[i].replied_to_content ||
+                back.original_sender != source[i].original_sender || back.file_path != source[i].file_path ||
+                back.is_read != source[i].is_read || back.edit_expiry_time != source[i].edit_expiry_time) {
+                std::cout << "❌ round-trip mismatch at " << i << std::endl;
+                return 1;
+            }
+        }
+        delete store;
+
+        std::cout << std::left << std::setw(12) << count << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(20) << vectorBytes << std::setw(16) << storeBytes << std::setw(18) << estimate
+                  << std::endl;
+    }
+    return 0;
+}
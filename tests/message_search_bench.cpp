@@ -0,0 +1,88 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cwctype>
+#include <functional>
+#include "../libs/Messaging/MessageCache.h"
+
+// جستجوی قدیمی (std::search با towlower برای هر کاراکتر) در برابر متن از پیش تاشده و فیلتر SIMD
+
+static bool containsIgnoreCase(const std::wstring& str, const std::wstring& keyword) {
+    auto it = std::search(str.begin(), str.end(), keyword.begin(), keyword.end(),
+                          [](wchar_t ch1, wchar_t ch2) { return std::towlower(ch1) == std::towlower(ch2); });
+    return it != str.end();
+}
+
+static double measureMs(const std::function<void()>& fn, int repeat = 5) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+}
+
+int main() {
+    const size_t count = 300000;
+    const std::wstring me = L"alice";
+    const std::vector<std::wstring> words = {
+        L"Hello", L"meeting", L"Tomorrow", L"project", L"deadline", L"سلام", L"جلسه", L"فردا",
+        L"پروژه", L"report", L"Coffee", L"lunch", L"update", L"release", L"بررسی", L"Review"
+    };
+
+    std::mt19937 rng(42);
+    MessageCache cache;
+    std::vector<ChatMessage> linear;
+    linear.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ChatMessage msg;
+        msg.id = L"m" + std::to_wstring(i);
+        bool outgoing = rng() % 2;
+        std::wstring peer = L"user" + std::to_wstring(rng() % 500);
+        msg.sender = outgoing ? me : peer;
+        msg.receiver = outgoing ? peer : me;
+        for (int w = 0; w < 12; w++) msg.content += words[rng() % words.size()] + L" ";
+        if (i % 1000 == 0) msg.content += L"Quarterly-Budget";
+        linear.push_back(msg);
+        cache.add(msg);
+    }
+
+    std::cout << "🎯 MESSAGE SEARCH (" << count << " cached messages)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(20) << "keyword" << std::right << std::setw(10) << "matches"
+              << std::setw(12) << "old ms" << std::setw(12) << "new ms" << std::endl;
+
+    const std::vector<std::pair<std::string, std::wstring>> keywords = {
+        {"rare", L"quarterly-budget"}, {"common, upper", L"DEADLINE"}, {"persian", L"جلسه"},
+        {"sender name", L"user42"}, {"no match", L"no-such-word"}
+    };
+    for (const auto& [label, keyword] : keywords) {
+        size_t oldMatches = 0;
+        double oldMs = measureMs([&]() {
+            std::vector<ChatMessage> results;
+            for (const auto& msg : linear) {
+                if (!msg.is_deleted && (containsIgnoreCase(msg.content, keyword) ||
+                                        containsIgnoreCase(msg.sender, keyword) ||
+                                        containsIgnoreCase(msg.receiver, keyword))) {
+                    results.push_back(msg);
+                }
+            }
+            oldMatches = results.size();
+        }, 2);
+
+        size_t newMatches = 0;
+        std::vector<std::wstring> ids;
+        double newMs = measureMs([&]() { newMatches = cache.search_involving(me, keyword, ids, 0, 50); });
+
+        if (oldMatches != newMatches) {
+            std::cout << "❌ mismatch for " << label << std::endl;
+            return 1;
+        }
+        std::cout << std::left << std::setw(20) << label
+                  << std::right << std::setw(10) << newMatches << std::fixed << std::setprecision(1)
+                  << std::setw(12) << oldMs << std::setw(12) << newMs << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <functional>
+#include "../libs/Messaging/MessageStore.h"
+
+// مقایسه‌ی جستجوی خطی در vector<ChatMessage> با MessageStore
+
+static double measureNsPerOp(const std::function<void()>& fn, size_t ops) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+static std::wstring randomId(std::mt19937& rng) {
+    const wchar_t* hex_chars = L"0123456789abcdef";
+    std::wstring id;
+    for (int i = 0; i < 32; ++i) {
+        id += hex_chars[rng() % 16];
+    }
+    return id;
+}
+
+static void runBenchmark(size_t count) {
+    std::mt19937 rng(42);
+    const size_t users = 1000;
+
+    std::vector<ChatMessage> linear;
+    MessageStore store;
+    linear.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ChatMessage msg;
+        msg.id = randomId(rng);
+        msg.sender = L"user" + std::to_wstring(rng() % users);
+        msg.receiver = L"user" + std::to_wstring(rng() % users);
+        msg.content = L"message " + std::to_wstring(i);
+        msg.timestamp = static_cast<time_t>(i);
+        linear.push_back(msg);
+        store.add(msg);
+    }
+
+    // The linear scan gets fewer probes so large sizes finish in reasonable time
+    std::vector<std::wstring> probes;
+    for (size_t i = 0; i < 1000; i++) probes.push_back(linear[rng() % count].id);
+    size_t linearProbes = std::min<size_t>(probes.size(), std::max<size_t>(10, 20000000 / count));
+    volatile long sink = 0;
+
+    double linearFind = measureNsPerOp([&]() {
+        for (size_t i = 0; i < linearProbes; i++) {
+            for (const auto& msg : linear) {
+                if (msg.id == probes[i]) { sink = sink + 1; break; }
+            }
+        }
+    }, linearProbes);
+    double storeFind = measureNsPerOp([&]() {
+        size_t slot;
+        for (const auto& id : probes) sink = sink + store.slot_of(id, slot);
+    }, probes.size());
+
+    const std::wstring user = L"user7";
+    double linearUnread = measureNsPerOp([&]() {
+        long unread = 0;
+        for (const auto& msg : linear) unread += (msg.receiver == user && !msg.is_read);
+        sink = sink + unread;
+    }, 1);
+    double storeUnread = measureNsPerOp([&]() {
+        long unread = 0;
+        for (size_t slot : store.received_by(user)) unread += !(store.flags(slot) & MessageStore::FLAG_READ);
+        sink = sink + unread;
+    }, 1);
+
+    std::cout << std::left << std::setw(12) << count
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << linearFind << std::setw(12) << storeFind
+              << std::setw(16) << linearUnread / 1000 << std::setw(14) << storeUnread / 1000
+              << std::endl;
+}
+
+int main() {
+    std::cout << "🎯 MESSAGE STORE MICROBENCHMARK (vector scan vs MessageStore)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(12) << "messages"
+              << std::right << std::setw(14) << "find ns scan" << std::setw(12) << "find ns idx"
+              << std::setw(16) << "unread us scan" << std::setw(14) << "unread us idx" << std::endl;
+
+    for (size_t count : {1000u, 10000u, 100000u, 1000000u}) {
+        runBenchmark(count);
+    }
+    return 0;
+}
@@ -0,0 +1,260 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <chrono>
+#include "../libs/Database/Database.h"
+#include "../libs/Messaging/MessageHandler.h"
+
+class MessageManagerTester {
+private:
+    Database database;
+    std::shared_ptr<MessagingBackend> backend;
+    int testCount = 0;
+    int passedCount = 0;
+
+    static ChatMessage makeMessage(const std::wstring& sender, const std::wstring& receiver, const std::wstring& content) {
+        ChatMessage msg;
+        msg.sender = sender;
+        msg.receiver = receiver;
+        msg.content = content;
+        msg.timestamp = time(nullptr);
+        msg.edit_expiry_time = 0;
+        return msg;
+    }
+
+    std::vector<Message> history(const std::string& user1, const std::string& user2) {
+        std::lock_guard<std::mutex> lock(backend->db_mutex);
+        return database.getMessageHistory(user1, user2);
+    }
+
+public:
+    MessageManagerTester() : database(":memory:"), backend(std::make_shared<MessagingBackend>()) {
+        backend->db = &database;
+    }
+
+    void printTestResult(const std::string& testName, bool success, const std::string& message = "") {
+        testCount++;
+        if (success) passedCount++;
+
+        std::cout << (success ? "✅ PASS" : "❌ FAIL") << " - " << testName;
+        if (!message.empty()) {
+            std::cout << " : " << message;
+        }
+        std::cout << std::endl;
+    }
+
+    void testSend() {
+        std::cout << "\n1. 📨 SEND TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        MessageManager alice(backend, L"alice");
+        bool sent = alice.send(makeMessage(L"alice", L"bob", L"Lunch at noon?"));
+        std::wstring id = alice.get_last_sent_id();
+        printTestResult("Send message", sent && !id.empty());
+
+        auto rows = history("alice", "bob");
+        printTestResult("Message stored in database", rows.size() == 1 && rows[0].content == "Lunch at noon?");
+
+        // A retry with the same client id is acknowledged without a second row
+        ChatMessage retry = makeMessage(L"alice", L"bob", L"Lunch at noon?");
+        retry.id = id;
+        printTestResult("Retry acknowledged", alice.send(retry) && alice.get_last_sent_id() == id);
+        printTestResult("Retry not stored twice", history("alice", "bob").size() == 1);
+
+        ChatMessage conflicting = makeMessage(L"alice", L"bob", L"Different text");
+        conflicting.id = id;
+        printTestResult("Reused id with other content rejected", !alice.send(conflicting));
+        printTestResult("Empty message rejected", !alice.send(makeMessage(L"alice", L"bob", L"   ")));
+    }
+
+    void testReceipts() {
+        std::cout << "\n2. ✓✓ RECEIPT TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        MessageManager alice(backend, L"alice");
+        MessageManager bob(backend, L"bob");
+        alice.send(makeMessage(L"alice", L"bob", L"Are you coming?"));
+        std::wstring first = alice.get_last_sent_id();
+        alice.send(makeMessage(L"alice", L"bob", L"The table is booked"));
+        std::wstring second = alice.get_last_sent_id();
+
+        printTestResult("Unread before receipts", bob.get_unread_count(L"bob") == 3,
+                        std::to_string(bob.get_unread_count(L"bob")));
+
+        printTestResult("Mark as delivered", bob.mark_as_delivered(first));
+        printTestResult("Mark as seen", bob.mark_as_seen(second));
+
+        // Seen is a watermark: it covers the earlier messages of the conversation too
+        auto last = bob.get_last_messages(3);
+        bool allSeen = last.size() == 3;
+        for (const auto& msg : last) {
+            allSeen &= msg.is_seen && msg.is_read;
+        }
+        printTestResult("Seen watermark covers earlier messages", allSeen);
+        printTestResult("Unread cleared", bob.get_unread_count(L"bob") == 0);
+
+        // Sent messages have ULIDs, not row ids: the watermark must still reach their rows
+        backend->receipts.flush();
+        auto rows = history("alice", "bob");
+        bool readInDatabase = rows.size() == 3;
+        for (const auto& row : rows) {
+            readInDatabase &= row.isRead;
+        }
+        printTestResult("Seen receipts stored in database", readInDatabase);
+        printTestResult("Unknown id rejected", !bob.mark_as_seen(L"no-such-message"));
+    }
+
+    void testSearch() {
+        std::cout << "\n3. 🔍 SEARCH TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        MessageManager carol(backend, L"carol");
+        carol.send(makeMessage(L"carol", L"dave", L"Project KICKOFF on Monday"));
+        carol.send(makeMessage(L"carol", L"dave", L"Kickoff slides attached"));
+        carol.send(makeMessage(L"carol", L"erin", L"Unrelated note"));
+
+        auto [total, found] = carol.search_messages(L"kickoff");
+        printTestResult("Case-insensitive search", total == 2 && found.size() == 2 &&
+                                                   found[0].content == L"Project KICKOFF on Monday");
+
+        auto [pagedTotal, page] = carol.search_messages(L"kickoff", 1, 1);
+        printTestResult("Search paging", pagedTotal == 2 && page.size() == 1 &&
+                                         page[0].content == L"Kickoff slides attached");
+
+        MessageManager alice(backend, L"alice");
+        printTestResult("Other users' messages not searched", alice.search_messages(L"kickoff").first == 0);
+
+        auto bySender = MessageManager(backend, L"dave").search_messages(L"carol");
+        printTestResult("Search matches sender", bySender.first == 2);
+    }
+
+    void testReload() {
+        std::cout << "\n4. 💾 RELOAD TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        // A fresh process over the same database sees the stored history
+        auto restarted = std::make_shared<MessagingBackend>();
+        restarted->db = &database;
+        MessageManager alice(restarted, L"alice");
+        alice.initialize();
+
+        auto loaded = alice.get_last_messages(10);
+        printTestResult("History loaded from database", loaded.size() == 3, std::to_string(loaded.size()));
+
+        if (!loaded.empty()) {
+            std::wstring id = loaded.front().id;
+            printTestResult("Edit loaded message", alice.edit_message(id, L"Lunch at one?", L"alice"));
+            auto rows = history("alice", "bob");
+            printTestResult("Edit stored in database", !rows.empty() && rows[0].content == "Lunch at one?" &&
+                                                       rows[0].isEdited);
+        }
+    }
+
+    void testOutbox() {
+        std::cout << "\n5. 📤 OUTBOX TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        const std::string journal = "messagemanager_test_outbox.log";
+        std::remove(journal.c_str());
+        {
+            // No database yet: sent messages stay queued in the journal
+            auto queued = std::make_shared<MessagingBackend>();
+            bool opened = queued->open_outbox(journal);
+            printTestResult("Outbox opened", opened);
+            if (!opened) {
+                return;
+            }
+
+            MessageManager frank(queued, L"frank");
+            MessageManager grace(queued, L"grace");
+            frank.send(makeMessage(L"frank", L"grace", L"Meet at the station"));
+            std::wstring edited = frank.get_last_sent_id();
+            frank.send(makeMessage(L"frank", L"grace", L"Bring the tickets"));
+            std::wstring deleted = frank.get_last_sent_id();
+
+            printTestResult("Edit queued message", frank.edit_message(edited, L"Meet at the airport", L"frank"));
+            printTestResult("Delete queued message", frank.delete_message(deleted, L"frank") &&
+                                                     grace.delete_message(deleted, L"grace"));
+
+            {
+                std::lock_guard<std::mutex> lock(queued->db_mutex);
+                queued->db = &database;
+            }
+            printTestResult("Outbox drained", queued->outbox->wait_drained(std::chrono::seconds(10)));
+        }
+        std::remove(journal.c_str());
+
+        // The flusher stores what the messages say now, not what the journal recorded
+        bool editStored = false, deleteStored = false, originalStored = false;
+        auto rows = history("frank", "grace");
+        for (const auto& row : rows) {
+            editStored |= row.content == "Meet at the airport" && row.isEdited;
+            deleteStored |= row.content == "این پیام حذف شده است";
+            originalStored |= row.content == "Meet at the station" || row.content == "Bring the tickets";
+        }
+        printTestResult("Edit of queued message stored", rows.size() == 2 && editStored);
+        printTestResult("Delete of queued message stored", deleteStored && !originalStored);
+    }
+
+    void testForward() {
+        std::cout << "\n6. ↪️ FORWARD TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        MessageManager heidi(backend, L"heidi");
+        MessageManager judy(backend, L"judy");
+        heidi.send(makeMessage(L"heidi", L"ivan", L"The venue moved to the harbour hall"));
+        std::wstring id = heidi.get_last_sent_id();
+        auto original = history("heidi", "ivan");
+
+        bool forwarded = heidi.forward_message(id, L"judy") && heidi.forward_message(id, L"judy");
+        printTestResult("Forward message", forwarded);
+
+        // Both forwards point at the original row and read back its text from the shared body
+        auto rows = history("heidi", "judy");
+        bool linked = original.size() == 1 && rows.size() == 2;
+        for (const auto& row : rows) {
+            linked &= row.content == "The venue moved to the harbour hall" &&
+                      row.forwardedFrom == original[0].id && row.forwardOrigin == "heidi";
+        }
+        printTestResult("Forwards stored with a shared body", linked);
+
+        // Forwards have ULIDs too: receipts still find their rows
+        auto inbox = judy.get_last_messages(2);
+        printTestResult("Forward is unread for the new receiver", judy.get_unread_count(L"judy") == 2);
+        bool seen = !inbox.empty() && judy.mark_as_seen(inbox.back().id);
+        backend->receipts.flush();
+        rows = history("heidi", "judy");
+        printTestResult("Seen receipt stored for forwards", seen && rows.size() == 2 && rows[0].isRead && rows[1].isRead);
+    }
+
+    void runAllTests() {
+        std::cout << "🎯 MESSAGE MANAGER TESTS" << std::endl;
+        std::cout << "==========================================" << std::endl;
+
+        try {
+            testSend();
+            testReceipts();
+            testSearch();
+            testReload();
+            testOutbox();
+            testForward();
+
+            std::cout << "\n==========================================" << std::endl;
+            std::cout << "📊 FINAL RESULTS: " << passedCount << "/" << testCount << " tests passed" << std::endl;
+            std::cout << "🎯 SUCCESS RATE: " << (passedCount * 100 / testCount) << "%" << std::endl;
+            std::cout << "==========================================" << std::endl;
+
+        } catch (const std::exception& e) {
+            std::cout << "❌ CRITICAL ERROR: " << e.what() << std::endl;
+        }
+    }
+};
+
+int main() {
+    MessageManagerTester tester;
+    tester.runAllTests();
+    return 0;
+}
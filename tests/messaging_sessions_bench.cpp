@@ -0,0 +1,107 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <functional>
+#include "../libs/Messaging/MessageCache.h"
+
+// چند هزار نشست هم‌زمان: کش مشترک شارد‌شده در برابر یک vector سراسری با یک قفل
+
+struct GlobalLockStore {
+    std::mutex mutex;
+    MessageStore store;
+};
+
+static double measureMs(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Each thread drives its share of the sessions; a session sends a few messages
+// to random peers, then asks for its unread count.
+static void runSessions(size_t sessions, size_t threads, size_t messagesPerSession,
+                        const std::function<void(const ChatMessage&)>& send,
+                        const std::function<int(const std::wstring&)>& unread) {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            long sink = 0;
+            for (size_t session = t; session < sessions; session += threads) {
+                std::wstring user = L"user" + std::to_wstring(session);
+                for (size_t i = 0; i < messagesPerSession; i++) {
+                    ChatMessage msg;
+                    msg.id = user + L"-" + std::to_wstring(i);
+                    msg.sender = user;
+                    msg.receiver = L"user" + std::to_wstring(rng() % sessions);
+                    msg.content = L"hello";
+                    msg.timestamp = static_cast<time_t>(i);
+                    send(msg);
+                }
+                sink += unread(user);
+            }
+            if (sink < 0) std::cout << sink;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+int main() {
+    const size_t sessions = 20000;
+    const size_t messagesPerSession = 20;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts = {1};
+    if (hardware > 1) threadCounts.push_back(hardware);
+    threadCounts.push_back(hardware * 4);   // Oversubscribed, as with one thread per connection
+
+    std::cout << "🎯 CONCURRENT SESSIONS BENCHMARK (" << sessions << " sessions x "
+              << messagesPerSession << " messages)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::right << std::setw(16) << "global lock ms" << std::setw(14) << "sharded ms" << std::endl;
+
+    for (size_t threads : threadCounts) {
+        GlobalLockStore global;
+        double globalMs = measureMs([&]() {
+            runSessions(sessions, threads, messagesPerSession,
+                        [&](const ChatMessage& msg) {
+                            std::lock_guard<std::mutex> lock(global.mutex);
+                            global.store.add(msg);
+                        },
+                        [&](const std::wstring& user) {
+                            std::lock_guard<std::mutex> lock(global.mutex);
+                            int count = 0;
+                            for (size_t slot : global.store.received_by(user)) {
+                                count += !(global.store.flags(slot) & MessageStore::FLAG_READ);
+                            }
+                            return count;
+                        });
+        });
+
+        MessageCache cache;
+        double shardedMs = measureMs([&]() {
+            runSessions(sessions, threads, messagesPerSession,
+                        [&](const ChatMessage& msg) { cache.add(msg); },
+                        [&](const std::wstring& user) {
+                            int count = 0;
+                            cache.for_each_received(user, [&count](const ChatMessage& m) { count += !m.is_read; });
+                            return count;
+                        });
+        });
+
+        if (cache.size() != global.store.size()) {
+            std::cout << "❌ size mismatch" << std::endl;
+            return 1;
+        }
+        std::cout << std::left << std::setw(10) << threads
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << globalMs << std::setw(14) << shardedMs << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
+#include <set>
+#include "../libs/DataBase/Database.h"
+#include "../libs/Messaging/Outbox.h"
+#include "../libs/Messaging/Utf8.h"
+
+// تأخیر send وقتی پایگاه داده زیر بار است: نوشتن مستقیم در برابر ژورنال outbox
+
+static const int sends = 1000;
+
+struct Latency {
+    double p50, p99, max;
+};
+
+static Latency summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return {samples[samples.size() / 2], samples[samples.size() * 99 / 100], samples.back()};
+}
+
+// Another connection's slow statements: holds the database for 20 ms out of every 50
+static void loadDatabase(std::mutex& dbMutex, std::atomic<bool>& running) {
+    while (running) {
+        {
+            std::lock_guard<std::mutex> lock(dbMutex);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+}
+
+static Latency measureSends(const std::function<void(int)>& send) {
+    std::vector<double> samples;
+    samples.reserve(sends);
+    for (int i = 0; i < sends; i++) {
+        auto start = std::chrono::steady_clock::now();
+        send(i);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    return summarize(samples);
+}
+
+static void printRow(const std::string& name, const Latency& latency) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << latency.p50 << std::setw(10) << latency.p99 << std::setw(10) << latency.max
+              << std::endl;
+}
+
+static OutboxEntry makeEntry(const std::wstring& id) {
+    OutboxEntry entry;
+    entry.id = id;
+    entry.sender = L"alice";
+    entry.receiver = L"bob";
+    entry.content = L"message " + id;
+    return entry;
+}
+
+// Concurrent appends with compaction after every drain, then a stop before everything is
+// delivered: each appended entry must be either delivered or handed back by the next open()
+static bool survivesCompaction(const std::string& journalPath) {
+    const int threads = 8;
+    const int perThread = 500;
+    std::remove(journalPath.c_str());
+    std::mutex deliveredMutex;
+    std::set<std::wstring> delivered;
+    Outbox::Options options;
+    options.sync = false;
+    options.compact_bytes = 0;
+    {
+        Outbox outbox(journalPath, [&](const OutboxEntry& entry) {
+            std::lock_guard<std::mutex> lock(deliveredMutex);
+            delivered.insert(entry.id);
+            return true;
+        }, options);
+        std::vector<OutboxEntry> pending;
+        outbox.open(pending);
+        outbox.start();
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; t++) {
+            writers.emplace_back([&outbox, t]() {
+                for (int i = 0; i < perThread; i++) {
+                    OutboxEntry entry = makeEntry(std::to_wstring(t) + L"-" + std::to_wstring(i));
+                    outbox.append(entry);
+                }
+            });
+        }
+        for (auto& writer : writers) writer.join();
+    }
+
+    Outbox reopened(journalPath, [](const OutboxEntry&) { return true; });
+    std::vector<OutboxEntry> pending;
+    reopened.open(pending);
+    for (const auto& entry : pending) delivered.insert(entry.id);
+    return delivered.size() == static_cast<size_t>(threads * perThread);
+}
+
+// An entry the database always rejects must not hold up the entries behind it
+static bool skipsPoisonEntry(const std::string& journalPath, Outbox::Stats& stats) {
+    const int behind = 20;
+    std::remove(journalPath.c_str());
+    Outbox::Options options;
+    options.retry_delay = std::chrono::milliseconds(1);
+    options.max_attempts = 3;
+    Outbox outbox(journalPath, [](const OutboxEntry& entry) { return entry.id != L"poison"; }, options);
+    std::vector<OutboxEntry> pending;
+    outbox.open(pending);
+    OutboxEntry poison = makeEntry(L"poison");
+    outbox.append(poison);
+    for (int i = 0; i < behind; i++) {
+        OutboxEntry entry = makeEntry(std::to_wstring(i));
+        outbox.append(entry);
+    }
+    outbox.start();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (outbox.stats().delivered < behind && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    stats = outbox.stats();
+    return stats.delivered == behind && stats.pending == 1 && stats.deferred >= 1;
+}
+
+int main() {
+    const std::string directPath = "outbox_direct.db";
+    const std::string outboxDbPath = "outbox_async.db";
+    const std::string journalPath = "outbox_bench.journal";
+    for (const auto& path : {directPath, outboxDbPath, journalPath}) std::remove(path.c_str());
+
+    std::mutex dbMutex;
+    Latency direct;
+    {
+        Database db(directPath);
+        std::atomic<bool> running{true};
+        std::thread load(loadDatabase, std::ref(dbMutex), std::ref(running));
+        direct = measureSends([&](int i) {
+            std::lock_guard<std::mutex> lock(dbMutex);
+            db.sendMessage("alice", "bob", "message " + std::to_string(i));
+        });
+        running = false;
+        load.join();
+    }
+
+    Latency journaled;
+    Outbox::Stats stats;
+    int stored = 0;
+    {
+        Database db(outboxDbPath);
+        Outbox outbox(journalPath, [&](const OutboxEntry& entry) {
+            std::lock_guard<std::mutex> lock(dbMutex);
+            return db.storeMessageOnce(wide_to_utf8(entry.id), wide_to_utf8(entry.sender),
+                                       wide_to_utf8(entry.receiver), wide_to_utf8(entry.content)) > 0;
+        });
+        std::vector<OutboxEntry> pending;
+        outbox.open(pending);
+        outbox.start();
+
+        std::atomic<bool> running{true};
+        std::thread load(loadDatabase, std::ref(dbMutex), std::ref(running));
+        journaled = measureSends([&](int i) {
+            OutboxEntry entry;
+            entry.id = L"m" + std::to_wstring(i);
+            entry.sender = L"alice";
+            entry.receiver = L"bob";
+            entry.content = L"message " + std::to_wstring(i);
+            outbox.append(entry);
+        });
+        running = false;
+        load.join();
+        outbox.wait_drained(std::chrono::seconds(30));
+        stats = outbox.stats();
+        stored = db.getTotalMessagesSent("alice");
+    }
+    bool compactionSafe = survivesCompaction(journalPath);
+    Outbox::Stats poisonStats;
+    bool poisonSkipped = skipsPoisonEntry(journalPath, poisonStats);
+    for (const auto& path : {directPath, outboxDbPath, journalPath}) std::remove(path.c_str());
+
+    if (stored != sends) {
+        std::cout << "❌ " << stored << " of " << sends << " messages reached the database" << std::endl;
+        return 1;
+    }
+    if (!compactionSafe) {
+        std::cout << "❌ compaction dropped an entry that was neither delivered nor replayed" << std::endl;
+        return 1;
+    }
+    if (!poisonSkipped) {
+        std::cout << "❌ a failing entry blocked the queue (" << poisonStats.delivered << " delivered)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "🎯 SEND LATENCY UNDER DATABASE LOAD (" << sends << " sends, ms)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(22) << "" << std::right << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+    printRow("direct database write", direct);
+    printRow("outbox (fsync)", journaled);
+    std::cout << "fsyncs: " << stats.syncs << ", delivered: " << stats.delivered << std::endl;
+    std::cout << "failing entry: moved back " << poisonStats.deferred << " times, "
+              << poisonStats.delivered << " entries behind it delivered" << std::endl;
+    return 0;
+}
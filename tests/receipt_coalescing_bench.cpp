@@ -0,0 +1,95 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include "../libs/DataBase/Database.h"
+#include "../libs/Messaging/ReceiptCoalescer.h"
+#include "../libs/Messaging/Utf8.h"
+
+// رسید «دیده شد» برای هر پیام: یک نوشتن برای هر پیام در برابر واترمارک‌های دسته‌ای
+
+static double measureMs(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static const int conversations = 50;
+static const int messagesPerConversation = 40;
+
+// Fills a fresh database; returns (sender, receiver, row id) in arrival order
+static std::vector<std::tuple<std::string, std::string, int>> seed(Database& db) {
+    std::vector<std::tuple<std::string, std::string, int>> rows;
+    int id = 0;
+    for (int m = 0; m < messagesPerConversation; m++) {
+        for (int c = 0; c < conversations; c++) {
+            std::string sender = "user" + std::to_string(c);
+            db.sendMessage(sender, "reader", "message " + std::to_string(m));
+            rows.emplace_back(sender, "reader", ++id);
+        }
+    }
+    return rows;
+}
+
+int main() {
+    const std::string perMessagePath = "receipts_per_message.db";
+    const std::string coalescedPath = "receipts_coalesced.db";
+    std::remove(perMessagePath.c_str());
+    std::remove(coalescedPath.c_str());
+
+    // The reader scrolls through everything: one seen receipt per message
+    size_t receipts = 0, perMessageWrites = 0, unreadAfterPerMessage = 0;
+    double perMessageMs;
+    {
+        Database db(perMessagePath);
+        auto rows = seed(db);
+        receipts = rows.size();
+        perMessageMs = measureMs([&]() {
+            for (const auto& row : rows) {
+                perMessageWrites += db.markMessageAsRead(std::get<2>(row));
+            }
+        });
+        unreadAfterPerMessage = static_cast<size_t>(db.getUnreadMessageCount("reader"));
+    }
+
+    ReceiptCoalescer::Stats stats;
+    size_t unreadAfterCoalesced = 0;
+    double coalescedMs;
+    {
+        Database db(coalescedPath);
+        auto rows = seed(db);
+        coalescedMs = measureMs([&]() {
+            ReceiptCoalescer coalescer([&db](const std::vector<ReceiptWatermark>& batch) {
+                return db.applyReceiptWatermarks(batch) >= 0;
+            });
+            for (const auto& row : rows) {
+                coalescer.add(utf8_to_wide(std::get<0>(row)), L"reader", Receipt::Seen, std::get<2>(row));
+            }
+            coalescer.flush();
+            stats = coalescer.stats();
+        });
+        unreadAfterCoalesced = static_cast<size_t>(db.getUnreadMessageCount("reader"));
+    }
+    std::remove(perMessagePath.c_str());
+    std::remove(coalescedPath.c_str());
+
+    if (unreadAfterPerMessage != 0 || unreadAfterCoalesced != 0) {
+        std::cout << "❌ messages left unread" << std::endl;
+        return 1;
+    }
+
+    std::cout << "🎯 SEEN RECEIPTS (" << receipts << " messages, " << conversations << " conversations)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(16) << "" << std::right << std::setw(14) << "transactions"
+              << std::setw(12) << "rows" << std::setw(12) << "ms" << std::endl;
+    std::cout << std::left << std::setw(16) << "per message" << std::right << std::setw(14) << perMessageWrites
+              << std::setw(12) << perMessageWrites << std::setw(12) << std::fixed << std::setprecision(1)
+              << perMessageMs << std::endl;
+    std::cout << std::left << std::setw(16) << "coalesced" << std::right << std::setw(14) << stats.batches
+              << std::setw(12) << stats.watermarks << std::setw(12) << coalescedMs << std::endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <functional>
+#include "../libs/Messaging/MessageCache.h"
+
+// آخرین پیام‌ها: کپی کل تاریخچه و برش انتها، پیمایش معکوس، و حلقه‌ی ثابت پیام‌های اخیر
+
+static double measureUs(const std::function<void()>& fn, int repeat) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / repeat;
+}
+
+static bool sameIds(const std::vector<ChatMessage>& a, const std::vector<ChatMessage>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].id != b[i].id) return false;
+    }
+    return true;
+}
+
+int main() {
+    const std::wstring me = L"alice";
+    const size_t limit = 10;
+    std::mt19937 rng(7);
+
+    std::cout << "🕘 LAST " << limit << " MESSAGES" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::right << std::setw(10) << "cached" << std::setw(14) << "copy-all us"
+              << std::setw(14) << "scan us" << std::setw(14) << "ring us" << std::endl;
+
+    for (size_t count : {1000, 10000, 100000, 1000000}) {
+        MessageCache cache;
+        std::vector<ChatMessage> linear;
+        linear.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            ChatMessage msg;
+            msg.id = L"m" + std::to_wstring(i);
+            // alice is in one message out of fifty; the rest is other users' traffic
+            bool mine = rng() % 50 == 0;
+            std::wstring peer = L"user" + std::to_wstring(rng() % 5000);
+            msg.sender = mine && rng() % 2 ? me : peer;
+            msg.receiver = mine && msg.sender == peer ? me : L"user" + std::to_wstring(rng() % 5000);
+            msg.content = L"message " + std::to_wstring(i);
+            msg.timestamp = static_cast<time_t>(i);
+            if (i % 97 == 0) {
+                msg.deleted_by_sender = msg.deleted_by_receiver = true;
+            }
+            linear.push_back(msg);
+            cache.add(msg);
+        }
+
+        auto live = [](const ChatMessage& msg) { return !(msg.deleted_by_sender && msg.deleted_by_receiver); };
+        std::vector<ChatMessage> oldResult, scanResult, ringResult;
+        int repeat = count >= 1000000 ? 3 : 20;
+        double oldUs = measureUs([&]() {
+            std::vector<ChatMessage> all;
+            for (const auto& msg : linear) {
+                if ((msg.sender == me || msg.receiver == me) && live(msg)) all.push_back(msg);
+            }
+            size_t from = all.size() > limit ? all.size() - limit : 0;
+            oldResult.assign(all.begin() + static_cast<std::ptrdiff_t>(from), all.end());
+        }, repeat);
+        double scanUs = measureUs([&]() { scanResult = cache.latest_involving(me, limit, live); }, 200);
+        double ringUs = measureUs([&]() { ringResult = cache.recent_involving(me, limit); }, 2000);
+
+        if (!sameIds(oldResult, scanResult) || !sameIds(oldResult, ringResult)) {
+            std::cout << "❌ results differ at " << count << " messages" << std::endl;
+            return 1;
+        }
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(1)
+                  << std::setw(14) << oldUs << std::setw(14) << scanUs << std::setw(14) << ringUs << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <functional>
+#include <unordered_map>
+#include "../libs/Bot/UserStatsTracker.h"
+#include "../libs/Bot/BotManager.h"
+
+// آمار ربات با تاریخچه‌ی رو به رشد: COUNT و پیمایش کامل در برابر شمارنده‌های جاری
+
+static double measureMs(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static const int users = 2000;
+static const int historyDays = 30;
+static const size_t historySizes[] = {10000, 100000, 1000000};
+static const int statsRequests = 2000;
+static const int circleSize = 50;       // Contacts a user writes to
+
+static std::string user(int u) { return "user" + std::to_string(u); }
+
+struct Event {
+    int from;
+    int to;
+    std::chrono::system_clock::time_point at;
+};
+
+// What fetchStats computes today: counts and top contact from the whole history
+static Stats scanStats(const std::vector<Event>& history, int u, std::chrono::system_clock::time_point now) {
+    Stats s;
+    PeriodStats today, week;
+    std::unordered_map<int, size_t> interactions;
+    auto dayStart = now - std::chrono::hours(24);
+    auto weekStart = now - std::chrono::hours(24 * 7);
+    for (const auto& e : history) {
+        if (e.from != u && e.to != u) continue;
+        bool sent = e.from == u;
+        (sent ? s.sentCount : s.receivedCount)++;
+        if (e.at > dayStart) (sent ? today.sentCount : today.receivedCount)++;
+        if (e.at > weekStart) (sent ? week.sentCount : week.receivedCount)++;
+        interactions[sent ? e.to : e.from]++;
+    }
+    size_t best = 0;
+    for (const auto& [contact, count] : interactions) {
+        if (count > best) {
+            best = count;
+            s.topContactId = user(contact);
+        }
+    }
+    s.topContactCount = best;
+    s.today = today;
+    s.last7Days = week;
+    return s;
+}
+
+// The rank-th contact in u's own circle: circles differ per user, so friendships are not mirrored
+static int contactOf(int u, int rank) {
+    uint64_t x = static_cast<uint64_t>(u) * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(rank) * 0xC2B2AE3D27D4EB4Full;
+    x ^= x >> 29;
+    int contact = static_cast<int>(x % (users - 1));
+    return contact >= u ? contact + 1 : contact;
+}
+
+// Each user writes mostly to the head of a small circle (Zipf); what it receives is spread out
+static std::vector<Event> makeHistory(size_t size, std::chrono::system_clock::time_point now) {
+    std::mt19937_64 rng(size);
+    std::vector<double> weights(circleSize);
+    for (int i = 0; i < circleSize; i++) weights[static_cast<size_t>(i)] = 1.0 / std::pow(i + 1, 1.1);
+    std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+    std::uniform_int_distribution<int> anyUser(0, users - 1);
+    std::uniform_int_distribution<int64_t> age(0, int64_t{historyDays} * 86400 - 1);
+
+    std::vector<Event> history(size);
+    for (size_t i = 0; i < size; i++) {
+        int from = anyUser(rng);
+        int to = contactOf(from, zipf(rng));
+        history[i] = {from, to, now - std::chrono::seconds(age(rng))};
+    }
+    return history;
+}
+
+static size_t interactionsWith(const std::vector<Event>& history, int u, const std::string& contact) {
+    size_t count = 0;
+    for (const auto& e : history) {
+        count += (e.from == u && user(e.to) == contact) || (e.to == u && user(e.from) == contact);
+    }
+    return count;
+}
+
+int main() {
+    auto now = std::chrono::system_clock::now();
+    std::cout << "🎯 BOT STATS (" << users << " users, " << historyDays << " days of history)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << std::left << std::setw(12) << "history" << std::right << std::setw(14) << "scan us"
+              << std::setw(14) << "tracker us" << std::setw(14) << "record ns" << std::setw(14) << "top match"
+              << std::endl;
+
+    for (size_t size : historySizes) {
+        std::vector<Event> history = makeHistory(size, now);
+        UserStatsTracker tracker;
+        double recordMs = measureMs([&]() {
+            for (const auto& e : history) tracker.record(user(e.from), user(e.to), e.at);
+        });
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> anyUser(0, users - 1);
+        std::vector<int> asked(statsRequests);
+        for (auto& u : asked) u = anyUser(rng);
+
+        size_t scanRequests = size >= 1000000 ? 50 : 400;
+        std::vector<Stats> scanned(scanRequests);
+        double scanMs = measureMs([&]() {
+            for (size_t i = 0; i < scanRequests; i++) scanned[i] = scanStats(history, asked[i], now);
+        });
+        std::vector<Stats> tracked(asked.size());
+        double trackMs = measureMs([&]() {
+            for (size_t i = 0; i < asked.size(); i++) tracked[i] = tracker.snapshot(user(asked[i]), now);
+        });
+
+        // Totals are exact and the top contact is a true heavy hitter. Rollups use calendar days, which
+        // lie inside the scan's rolling 24 h / 7 day windows, so those are upper bounds
+        auto within = [](const PeriodStats& inner, const PeriodStats& outer) {
+            return inner.sentCount <= outer.sentCount && inner.receivedCount <= outer.receivedCount;
+        };
+        size_t topMatches = 0;
+        for (size_t i = 0; i < scanRequests; i++) {
+            const Stats& exact = scanned[i];
+            const Stats& fast = tracked[i];
+            if (fast.sentCount != exact.sentCount || fast.receivedCount != exact.receivedCount ||
+                !within(*fast.today, *exact.today) || !within(*fast.last7Days, *exact.last7Days) ||
+                !within(*fast.today, *fast.last7Days)) {
+                std::cout << "❌ counters differ for " << user(asked[i]) << std::endl;
+                return 1;
+            }
+            // Ties are common, so a match means the sketch's pick has the highest exact count
+            size_t actual = interactionsWith(history, asked[i], *fast.topContactId);
+            topMatches += actual == *exact.topContactCount;
+            SpaceSaving::Counter top;
+            for (const auto& c : tracker.topContacts(user(asked[i]))) {
+                if (c.key == *fast.topContactId) top = c;
+            }
+            if (top.count - top.error > actual || actual > top.count) {
+                std::cout << "❌ top contact count outside its error bound" << std::endl;
+                return 1;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << std::left << std::setw(12) << size << std::right
+                  << std::setw(14) << scanMs * 1000 / static_cast<double>(scanRequests)
+                  << std::setw(14) << trackMs * 1000 / static_cast<double>(asked.size())
+                  << std::setw(14) << recordMs * 1e6 / static_cast<double>(size)
+                  << std::setw(13) << 100.0 * static_cast<double>(topMatches) / static_cast<double>(scanRequests)
+                  << "%" << std::endl;
+    }
+
+    // Rollups by calendar day and week
+    UserStatsTracker tracker;
+    auto day = std::chrono::hours(24);
+    auto monday = std::chrono::system_clock::time_point(std::chrono::hours(24 * 4)) + day * 7 * 2900;
+    tracker.record("a", "b", monday + std::chrono::hours(1));
+    tracker.record("a", "b", monday + day * 2);
+    tracker.record("b", "a", monday + day * 2 + std::chrono::hours(3));
+    tracker.record("a", "c", monday - std::chrono::hours(1));     // Previous week
+    tracker.record("a", "c", monday - day * 30);                   // Out of the rings, totals only
+    Stats a = tracker.snapshot("a", monday + day * 2 + std::chrono::hours(5));
+    bool rollups = a.sentCount == 4 && a.receivedCount == 1 && a.today->sentCount == 1 && a.today->receivedCount == 1 &&
+                   a.thisWeek->sentCount == 2 && a.last7Days->sentCount == 3 && a.topContactId == std::string("b");
+    if (!rollups) {
+        std::cout << "❌ daily/weekly rollups wrong" << std::endl;
+        return 1;
+    }
+    std::cout << "\nrollups: today, last 7 days and this week match (" << tracker.userCount() << " users)" << std::endl;
+
+    // Through the bot: message events feed a shared tracker and the stats reply never calls fetchStats
+    auto shared = std::make_shared<UserStatsTracker>();
+    bool scanned = false;
+    BotManagerDeps deps;
+    deps.fetchStats = [&scanned]() {
+        scanned = true;
+        return Stats{};
+    };
+    BotManagerConfig cfg;
+    cfg.userId = "alice";
+    BotManager bot(deps, cfg, nullptr, nullptr, shared);
+    bot.onMessageEvent("alice", "bob");
+    bot.onMessageEvent("alice", "bob");
+    bot.onMessageEvent("carol", "alice");
+    bot.onMessageEvent("carol", "alice", false);    // Read receipt: not a new message
+    std::string reply = bot.handleChoice(static_cast<int>(MenuItem::Stats));
+    if (scanned || reply.find("- Sent: 2\n- Received: 1\n") == std::string::npos ||
+        reply.find("Most interaction with: bob") == std::string::npos) {
+        std::cout << "❌ bot stats not served from the tracker:\n" << reply << std::endl;
+        return 1;
+    }
+    std::cout << "bot: stats reply served from the tracker fed by message events" << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <codecvt>
+#include <locale>
+#include <functional>
+#include "../libs/Messaging/Utf8.h"
+
+// مقایسه‌ی wstring_convert با تبدیل‌گر جدید UTF-8 روی متن فارسی، ایموجی و ASCII
+
+static double measureNsPerByte(const std::function<void()>& fn, size_t bytes, int repeat = 20) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / repeat / bytes;
+}
+
+static bool check(const std::string& name, bool ok) {
+    std::cout << (ok ? "✅ " : "❌ ") << name << std::endl;
+    return ok;
+}
+
+static bool runCorrectnessChecks() {
+    bool ok = true;
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> reference;
+
+    std::string persian = u8"سلام دنیا! این یک پیام آزمایشی است.";
+    std::string emoji = u8"😀🎉👍 hi 🚀";
+    ok &= check("Persian round trip", wide_to_utf8(utf8_to_wide(persian)) == persian);
+    ok &= check("Emoji round trip", wide_to_utf8(utf8_to_wide(emoji)) == emoji);
+    ok &= check("Matches wstring_convert", utf8_to_wide(persian + emoji) == reference.from_bytes(persian + emoji));
+    ok &= check("Valid input accepted", utf8_is_valid(persian + emoji));
+
+    // Maximal subparts: truncated 3-byte sequence, stray continuation, overlong, surrogate
+    ok &= check("Truncated sequence", utf8_to_wide("a\xE2\x82" "b") == L"a�b");
+    ok &= check("Stray continuation", utf8_to_wide("\x80\x80") == L"��");
+    ok &= check("Overlong rejected", utf8_to_wide("\xC0\xAF") == L"��" && !utf8_is_valid("\xC0\xAF"));
+    ok &= check("Encoded surrogate rejected", utf8_to_wide("\xED\xA0\x80") == L"���");
+    ok &= check("Above U+10FFFF rejected", !utf8_is_valid("\xF4\x90\x80\x80"));
+    if (sizeof(wchar_t) == 4) {
+        ok &= check("Lone surrogate encoded as U+FFFD",
+                    wide_to_utf8(std::wstring(1, static_cast<wchar_t>(0xD800))) == "\xEF\xBF\xBD");
+    }
+    return ok;
+}
+
+static void runBenchmark(const std::string& label, const std::string& text) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> reference;
+    std::wstring wide = utf8_to_wide(text);
+    volatile size_t sink = 0;
+
+    // The old code built a converter per call, so the baseline does too
+    double oldDecode = measureNsPerByte([&]() {
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+        sink = sink + converter.from_bytes(text).size();
+    }, text.size());
+    double newDecode = measureNsPerByte([&]() { sink = sink + utf8_to_wide(text).size(); }, text.size());
+    double oldEncode = measureNsPerByte([&]() {
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+        sink = sink + converter.to_bytes(wide).size();
+    }, text.size());
+    double newEncode = measureNsPerByte([&]() { sink = sink + wide_to_utf8(wide).size(); }, text.size());
+
+    std::cout << std::left << std::setw(14) << label
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << oldDecode << std::setw(12) << newDecode
+              << std::setw(12) << oldEncode << std::setw(12) << newEncode << std::endl;
+}
+
+static std::string repeatTo(const std::string& unit, size_t bytes) {
+    std::string text;
+    while (text.size() < bytes) text += unit;
+    return text;
+}
+
+int main() {
+    std::cout << "🎯 UTF-8 TRANSCODING" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    if (!runCorrectnessChecks()) {
+        return 1;
+    }
+
+    std::cout << "\nns/byte        " << std::right << std::setw(12) << "decode old" << std::setw(12) << "decode new"
+              << std::setw(12) << "encode old" << std::setw(12) << "encode new" << std::endl;
+
+    std::string persian = u8"سلام دوست عزیز، امروز جلسه ساعت ده برگزار می‌شود. ";
+    std::string emoji = u8"😀🎉👍🚀❤️ عالی بود 😂😂 ";
+    std::string ascii = "Meeting moved to 10am, see you there! ";
+
+    // Short chat messages (the history-loading case) and one long document
+    for (size_t bytes : {64u, 65536u}) {
+        runBenchmark("persian " + std::to_string(bytes), repeatTo(persian, bytes));
+        runBenchmark("emoji " + std::to_string(bytes), repeatTo(emoji, bytes));
+        runBenchmark("ascii " + std::to_string(bytes), repeatTo(ascii, bytes));
+    }
+    return 0;
+}